@@ -1,4 +1,5 @@
 #include <curses.h>
+#include <cstdlib>
 #include <optional>
 #include <memory>
 #include <nlohmann/json.hpp>
@@ -77,6 +78,13 @@ std::string abc_string = "!\"#$%&'()*+,-./0123456789:;<=>?@ AB°CDEFGHIJKLMNOPQR
 
 int main() {
     sequence::SequenceManager* sequence_manager_ptr = nullptr;
+
+    auto geometry = display::Geometry::fromEnvironment();
+    auto refresh_rate = display::refreshRateFromEnvironment(REFRESH_RATE, MAX_REFRESH_RATE);
+    if (!geometry || !refresh_rate) {
+        return 1;
+    }
+
     init_curses();
     
     auto preUpdate = [] { clear(); };
@@ -97,7 +105,8 @@ int main() {
         sequence_manager_ptr->onScrollComplete();
     };
     
-    auto display = std::make_unique<display::DisplayImpl>(preUpdate, postUpdate, displayStateCallback, scrollCompleteCallback);
+    auto display = std::make_unique<display::DisplayImpl>(*geometry, preUpdate, postUpdate, displayStateCallback, scrollCompleteCallback);
+    display->setRefreshRate(*refresh_rate);
     auto sequence_manager = std::make_shared<sequence::SequenceManager>(
         std::move(display)
     );
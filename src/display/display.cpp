@@ -1,9 +1,8 @@
+#include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <ctime>
-#include <iomanip>
 #include <optional>
-#include <sstream>
 
 #include "display.hpp"
 #include "timer.hpp"
@@ -19,20 +18,29 @@ using namespace std::chrono_literals;
 
 static constexpr bool show_time_divider = true;
 
+// Longest step an animation takes at once, e.g. after the frame loop stalled
+static constexpr double max_frame_delta = 0.25;  // Seconds
+
 Display::Display(
+    size_t width,
     std::function<void()> preUpdate,
     std::function<void()> postUpdate,
     DisplayStateCallback stateCallback,
     std::function<void()> scrollCompleteCallback
 )
-    : preUpdate(preUpdate),
+    : displayWidth(width),
+      displayBuffer(width, 0),
+      fixedColumns(width, 0),
+      preUpdate(preUpdate),
       postUpdate(postUpdate),
       displayStateCallback(stateCallback),
       scrollCompleteCallback(scrollCompleteCallback)
 {
+    timeText.setFormat(timeFormat);
+
     // Initialize transition manager with display buffer update callback
     transition_manager = std::make_unique<transition::TransitionManager>(
-        [this](const std::array<uint8_t, X_MAX>& buffer) {
+        [this](const Framebuffer& buffer) {
             this->displayBuffer = buffer;
         }
     );
@@ -44,35 +52,28 @@ Display::~Display()
 }
 
 bool Display::prepare()
+{
+    return prepare(1.0 / refreshRate);
+}
+
+bool Display::prepare(double deltaTime)
 {
     // Let sequence processing continue normally even during pong
     // This preserves sequence state and allows new sequence elements
     
-    auto textSize = static_cast<int>(renderedText.size());
-    
-    // Check if time needs update BEFORE calling renderTimeOptimized (which resets the flag)
-    bool timeChanged = timeNeedsUpdate;
-    if (!timeChanged && (mode == Mode::TIME || mode == Mode::TIME_AND_TEXT)) {
-        auto currentTime = std::time(nullptr);
-        timeChanged = (currentTime != lastTimeRendered || timeFormat != lastTimeFormat);
+    const auto changedTime = renderTime();
+    const bool timeChanged = !changedTime.empty();
+    if (dirty) {
+        layoutContent(timeText.columns());
+    } else if (timeChanged) {
+        patchTime(changedTime);
     }
-    
-    const auto& time = renderTimeOptimized();  // Use cached version
-    auto textBlock = static_cast<int>(X_MAX - time.size());
 
     bool scrollChanged = false;
-    bool shouldScroll = false;
-    
-    if (mode == Mode::TIME) {
-        // TIME mode scrolls only when content is longer than display width AND scrolling is enabled
-        shouldScroll = (scrollDirection == Scrolling::ENABLED) && 
-                      (static_cast<int>(time.size()) > X_MAX);
-    } else if (mode == Mode::TEXT || mode == Mode::TIME_AND_TEXT) {
-        int availableSpace = (mode == Mode::TEXT) ? X_MAX : textBlock;
-        // Only scroll when content is longer than available space AND scrolling is enabled
-        shouldScroll = (scrollDirection == Scrolling::ENABLED) && 
-                      (textSize > availableSpace);
-    }
+
+    // Only scroll when content is longer than its window AND scrolling is enabled
+    bool shouldScroll = (scrollDirection == Scrolling::ENABLED) && scrollStrip.overflows();
+    scrollActive = shouldScroll;
 
     // Hack to fix floating point comparison
     if (std::round(scrollDelayTimer*100) >= std::round(SCROLL_DELAY*100) && !transition_manager->isTransitioning())
@@ -81,8 +82,9 @@ bool Display::prepare()
         {
             scrollCompleteCallback();
             // Reset to beginning and start delay before next scroll cycle
-            scrollDelayTimer = 1.0 / REFRESH_RATE;  // Start timing from next cycle
+            scrollDelayTimer = deltaTime;  // Start timing from next cycle
             scrollOffset = 0;
+            scrollPosition = 0.0;
             scrollChanged = true;
         }
         else
@@ -94,30 +96,24 @@ bool Display::prepare()
     else if (scrollDelayTimer >= 0.0)
     {
         // Accumulate time for delay before starting/restarting scroll
-        scrollDelayTimer += 1.0 / REFRESH_RATE;
+        scrollDelayTimer += deltaTime;
     }
     
     if (scrollDelayTimer == -1)
     {
         if (shouldScroll)
         {
-            ++scrollOffset;
-            scrollChanged = true;
-            
-            // Check if we've reached the end (content fully visible on right edge)
-            bool reachedEnd = false;
-            if (mode == Mode::TIME) {
-                // Stop when end of time content is at right edge of display
-                reachedEnd = (scrollOffset + X_MAX >= static_cast<int>(time.size()));
-            } else if (mode == Mode::TEXT) {
-                // Stop when end of text content is at right edge of display
-                reachedEnd = (scrollOffset + X_MAX >= textSize);
-            } else if (mode == Mode::TIME_AND_TEXT) {
-                // Stop when end of text content is at right edge of available text area
-                reachedEnd = (scrollOffset + textBlock >= textSize);
-            }
+            // Move by the time that actually passed, at any frame rate
+            auto lastOffset = static_cast<double>(scrollStrip.size() - scrollStrip.window());
+            scrollPosition = std::min(scrollPosition + scrollSpeed * deltaTime, lastOffset);
+
+            // Whole columns only, the epsilon keeps rounding errors from dropping a step
+            auto offset = static_cast<int>(scrollPosition + 1e-9);
+            scrollChanged = (offset != scrollOffset);
+            scrollOffset = offset;
             
-            if (reachedEnd) {
+            // Stop when the end of the content is at the right edge of its window
+            if (scrollPosition >= lastOffset) {
                 scrollDelayTimer = 0;  // Start delay timer before restarting
             }
         }
@@ -125,6 +121,7 @@ bool Display::prepare()
         {
             // Reset scroll when scrolling is disabled
             scrollOffset = 0;
+            scrollPosition = 0.0;
             scrollChanged = true;
         }
     }
@@ -134,18 +131,19 @@ bool Display::prepare()
     
     if (hasChanges)
     {
-        auto newBuffer = createDisplayBufferOptimized(time);
+        composeFrame(nextBuffer);
         
         // If we have a default transition and buffer changed, use it
         if (default_transition_type != transition::Type::NONE && 
-            newBuffer != displayBuffer && 
+            nextBuffer != displayBuffer && 
             !transition_manager->isTransitioning()) {
             
             transition_manager->setCurrentBuffer(displayBuffer);
-            transition_manager->startTransition(newBuffer, default_transition_type, default_transition_duration);
+            transition_manager->startTransition(nextBuffer, default_transition_type, default_transition_duration);
         } else {
-            // Normal update path - set display buffer and keep transition manager in sync
-            displayBuffer = newBuffer;
+            // Normal update path - set display buffer and keep transition manager in sync,
+            // the old buffer is overwritten by the next composeFrame()
+            displayBuffer.swap(nextBuffer);
             transition_manager->setCurrentBuffer(displayBuffer);
         }
         dirty = false;
@@ -153,9 +151,7 @@ bool Display::prepare()
     
     // Update any active transitions
     if (transition_manager->isTransitioning()) {
-        // Use a fixed delta time based on refresh rate for consistent animation
-        double delta_time = 1.0 / REFRESH_RATE;
-        transition_manager->update(delta_time);
+        transition_manager->update(deltaTime);
     }
     
     // Handle pong overlay independently of sequence processing
@@ -177,193 +173,286 @@ bool Display::prepare()
 
 void Display::start()
 {
-    auto frame_time = std::chrono::duration<double, std::milli>(1000.0 / REFRESH_RATE);
-    auto timer = std::make_unique<timer::Timer>();
-    timer->setInterval([this] {
-        // Check if prepare() detected any changes (including time updates)
-        bool hasChanges = prepare(); // Handle transitions and buffer updates
-        
-        // Update display if changes detected OR if transition is active
-        if (hasChanges || transition_manager->isTransitioning())
-        {
-            preUpdate();
-            update();
-            postUpdate();
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        if (frameTimer) {
+            return;
         }
-    }, std::chrono::duration_cast<std::chrono::nanoseconds>(frame_time));
-    
-    timers.push_back(std::move(timer));
+        frameTimer = std::make_unique<timer::Timer>();
+    }
+    requestFrame();
 }
 
 void Display::stop()
 {
-    for (auto &timer : timers)
+    std::unique_ptr<timer::Timer> timer;
     {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        timer = std::move(frameTimer);
+        nextFrameReason = FrameReason::NONE;
+    }
+
+    // Stop outside the lock, a running frame may be waiting to reschedule itself
+    if (timer) {
         timer->stop();
     }
-    timers.clear();
 }
 
-static std::string getTime(std::string format)
+void Display::runFrame()
 {
-    std::stringstream displayText;
+    using namespace std::chrono;
+
+    const auto frameStart = steady_clock::now();
+    const double frameTime = 1.0 / refreshRate;
+
+    FrameReason reason;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        reason = nextFrameReason;
+        nextFrameReason = FrameReason::NONE;
+    }
 
-    auto t = std::time(nullptr);
-    auto tm = *std::localtime(&t);
-    displayText << std::put_time(&tm, format.c_str());
+    switch (reason) {
+        case FrameReason::ANIMATION: animationWakeups++; break;
+        case FrameReason::CLOCK: clockWakeups++; break;
+        case FrameReason::CONTENT: contentWakeups++; break;
+        case FrameReason::NONE: break;
+    }
+
+    // Animations advance by the time that actually passed since the last
+    // animation frame, a frame after idling or a stall counts as one period
+    double deltaTime = frameTime;
+    if (reason == FrameReason::ANIMATION && lastAnimationFrame != steady_clock::time_point{}) {
+        deltaTime = std::min(duration<double>(frameStart - lastAnimationFrame).count(), max_frame_delta);
+    }
+    lastAnimationFrame = frameStart;
+
+    // Check if prepare() detected any changes (including time updates)
+    bool hasChanges = prepare(deltaTime); // Handle transitions and buffer updates
+
+    // Update display if changes detected OR if transition is active
+    if (hasChanges || transition_manager->isTransitioning())
+    {
+        preUpdate();
+        update();
+        postUpdate();
+    }
 
-    return displayText.str();
+    const auto work = duration_cast<nanoseconds>(steady_clock::now() - frameStart);
+    frames++;
+    frameTimeTotal += work.count();
+    if (work.count() > frameTimeWorst) {
+        frameTimeWorst = work.count();
+    }
+    if (work > duration<double>(frameTime)) {
+        framesOverBudget++;
+    }
+
+    scheduleNextFrame(work);
 }
 
-std::vector<uint8_t> Display::renderTime()
+// Run at full rate only while something moves, otherwise sleep until the
+// shown time changes or until requestFrame() reports new content
+void Display::scheduleNextFrame(std::chrono::nanoseconds work)
 {
-    if (mode == Mode::TIME || mode == Mode::TIME_AND_TEXT)
-    {
-        return font::renderString(getTime(timeFormat));
+    std::lock_guard<std::mutex> lock(frameMutex);
+
+    // Stopped, or content changed while rendering and its frame is already queued
+    if (!frameTimer || nextFrameReason == FrameReason::CONTENT) {
+        return;
+    }
+
+    auto frame = [this] { runFrame(); };
+
+    if (dirty || scrollActive || scrollOffset != 0 || transition_manager->isTransitioning() || isPongActive()) {
+        // Time spent rendering is part of the period, so the rate holds while within budget
+        auto frame_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>(1.0 / refreshRate));
+        nextFrameReason = FrameReason::ANIMATION;
+        frameTimer->setTimeout(frame, std::max(frame_time - work, std::chrono::nanoseconds::zero()));
+    } else if (mode == Mode::TIME || mode == Mode::TIME_AND_TEXT) {
+        // Wake just past the next wall clock second so std::time() has moved on
+        auto now = std::chrono::system_clock::now();
+        auto next_second = std::chrono::floor<std::chrono::seconds>(now) + 1s;
+        nextFrameReason = FrameReason::CLOCK;
+        frameTimer->setTimeout(frame, next_second - now + 1ms);
+    }
+}
+
+void Display::requestFrame()
+{
+    std::lock_guard<std::mutex> lock(frameMutex);
+
+    // Not started, or an animation frame is coming soon anyway
+    if (!frameTimer || nextFrameReason == FrameReason::ANIMATION || nextFrameReason == FrameReason::CONTENT) {
+        return;
+    }
+
+    nextFrameReason = FrameReason::CONTENT;
+    frameTimer->setTimeout([this] { runFrame(); }, std::chrono::nanoseconds::zero());
+}
+
+FrameStats Display::getFrameStats() const
+{
+    FrameStats stats;
+    stats.animation_wakeups = animationWakeups.load();
+    stats.clock_wakeups = clockWakeups.load();
+    stats.content_wakeups = contentWakeups.load();
+    stats.frames = frames.load();
+    stats.frames_over_budget = framesOverBudget.load();
+    if (stats.frames > 0) {
+        stats.average_frame_time = std::chrono::nanoseconds(frameTimeTotal.load() / static_cast<int64_t>(stats.frames));
     }
-    return std::vector<uint8_t>();
+    stats.worst_frame_time = std::chrono::nanoseconds(frameTimeWorst.load());
+    return stats;
 }
 
-const std::vector<uint8_t>& Display::renderTimeOptimized()
+ColumnRange Display::renderTime()
 {
     if (mode != Mode::TIME && mode != Mode::TIME_AND_TEXT)
     {
-        static std::vector<uint8_t> empty;
-        return empty;
+        return {};
     }
-    
+
     auto currentTime = std::time(nullptr);
-    
-    // Check if we need to update the cached time
-    if (timeNeedsUpdate || 
-        currentTime != lastTimeRendered || 
-        timeFormat != lastTimeFormat)
+    if (!timeNeedsUpdate && currentTime == lastTimeRendered)
     {
-        cachedRenderedTime = font::FontCache::renderStringOptimized(getTime(timeFormat));
-        lastTimeRendered = currentTime;
-        lastTimeFormat = timeFormat;
-        timeNeedsUpdate = false;
+        return {};
     }
-    
-    return cachedRenderedTime;
+
+    lastTimeRendered = currentTime;
+    timeNeedsUpdate = false;
+
+    return timeText.render(localTime.at(currentTime));
 }
 
-std::array<uint8_t, X_MAX> Display::createDisplayBuffer(std::vector<uint8_t> time)
+void Display::layoutContent(const std::vector<uint8_t>& time)
 {
-    std::array<uint8_t, X_MAX> rendered = {0};
-    
-    // Handle different display modes with unified logic
+    fixedColumns.assign(displayWidth, 0);
+    windowStart = 0;
+    fixedTimeStart.reset();
+    fixedTimeWidth = 0;
+    scrollStrip.clear();
+
     switch (mode) {
         case Mode::TIME:
-            return createTimeOnlyBuffer(rendered, time);
-            
+            if (time.size() <= displayWidth) {
+                // A time that fits never scrolls, so its changed fields can be patched in place
+                const size_t start = alignment == Alignment::CENTER ? calculateCenterOffset(time.size(), displayWidth) : 0;
+                std::copy(time.begin(), time.end(), fixedColumns.begin() + static_cast<std::ptrdiff_t>(start));
+                fixedTimeStart = start;
+                fixedTimeWidth = time.size();
+            } else {
+                scrollStrip.assign(time, displayWidth);
+            }
+            break;
+
         case Mode::TEXT:
-            return createTextOnlyBuffer(rendered);
-            
-        case Mode::TIME_AND_TEXT:
-            return createTimeAndTextBuffer(rendered, time);
+            layoutText(0, 0);
+            break;
+
+        case Mode::TIME_AND_TEXT: {
+            // Time stays on the left, only the text after the divider scrolls
+            size_t pos = std::min(time.size(), displayWidth);
+            std::copy_n(time.begin(), pos, fixedColumns.begin());
+            fixedTimeStart = 0;
+            fixedTimeWidth = pos;
+
+            size_t gap = 0;
+            if (show_time_divider && pos < displayWidth) {
+                fixedColumns[pos++] = 0xFF;  // Vertical divider
+                gap = 1;                     // 1 pixel gap before text starts
+            }
+            layoutText(pos, gap);
+            break;
+        }
     }
-    
-    return rendered;
 }
 
-std::array<uint8_t, X_MAX> Display::createDisplayBufferOptimized(const std::vector<uint8_t>& time)
+void Display::layoutText(size_t pos, size_t gap)
 {
-    std::array<uint8_t, X_MAX> rendered = {0};
-    
-    // Handle different display modes with unified logic (using const reference)
-    switch (mode) {
-        case Mode::TIME:
-            return createTimeOnlyBuffer(rendered, time);
-            
-        case Mode::TEXT:
-            return createTextOnlyBuffer(rendered);
-            
-        case Mode::TIME_AND_TEXT:
-            return createTimeAndTextBuffer(rendered, time);
+    if (pos >= displayWidth) {
+        return;
     }
-    
-    return rendered;
-}
 
-std::array<uint8_t, X_MAX> Display::createTimeOnlyBuffer(std::array<uint8_t, X_MAX>& rendered, const std::vector<uint8_t>& time)
-{
-    return createBufferWithContent(rendered, &time, nullptr, false);
-}
+    size_t availableSpace = displayWidth - pos;
+    size_t lead = gap;
+    if (alignment == Alignment::CENTER && gap + renderedText.width() < availableSpace) {
+        lead += calculateCenterOffset(renderedText.width(), availableSpace - gap);
+    }
 
-std::array<uint8_t, X_MAX> Display::createTextOnlyBuffer(std::array<uint8_t, X_MAX>& rendered)
-{
-    return createBufferWithContent(rendered, nullptr, &renderedText, false);
+    windowStart = pos;
+    auto source = [this](size_t first, size_t count, uint8_t* destination) {
+        renderedText.render(first, count, destination);
+    };
+    scrollStrip.assign(source, renderedText.width(), availableSpace, lead);
 }
 
-std::array<uint8_t, X_MAX> Display::createTimeAndTextBuffer(std::array<uint8_t, X_MAX>& rendered, const std::vector<uint8_t>& time)
+void Display::patchTime(ColumnRange changed)
 {
-    return createBufferWithContent(rendered, &time, &renderedText, true);
-}
+    const auto& time = timeText.columns();
 
-std::array<uint8_t, X_MAX> Display::createBufferWithContent(std::array<uint8_t, X_MAX>& rendered, 
-                                                        const std::vector<uint8_t>* timeContent,
-                                                        const std::vector<uint8_t>* textContent,
-                                                        bool addDivider)
-{
-    size_t pos = 0;
-    
-    // Render time content if provided
-    if (timeContent && !timeContent->empty()) {
-        if (alignment == Alignment::CENTER && static_cast<int>(timeContent->size()) <= X_MAX && !textContent) {
-            // Center time-only content
-            size_t centerOffset = calculateCenterOffset(timeContent->size(), X_MAX);
-            for (size_t i = 0; i < timeContent->size() && centerOffset + i < X_MAX; i++) {
-                rendered[centerOffset + i] = timeContent->at(i);
-            }
-            return rendered;
-        } else {
-            // Left-align time content or part of time+text
-            for (; pos < timeContent->size() && pos < X_MAX; pos++) {
-                rendered[pos] = timeContent->at(pos);
-            }
-            
-            // Add divider between time and text if requested
-            if (addDivider && textContent) {
-                pos = addTimeDivider(rendered, pos);
-            }
-        }
+    // A time that scrolls, or changed width and moved what follows it, is laid out again.
+    // One cut off at the right edge keeps its place as long as it still is.
+    if (!fixedTimeStart || (time.size() != fixedTimeWidth
+                            && (time.size() < fixedTimeWidth || *fixedTimeStart + fixedTimeWidth < displayWidth))) {
+        layoutContent(time);
+        return;
     }
-    
-    // Render text content if provided
-    if (textContent && !textContent->empty()) {
-        // Handle centering for text content
-        if (alignment == Alignment::CENTER) {
-            size_t availableSpace = X_MAX - pos;
-            if (textContent->size() < availableSpace) {
-                pos += calculateCenterOffset(textContent->size(), availableSpace);
-            }
-        }
-        
-        // Render the text content
-        renderContentToBuffer(rendered, *textContent, pos, X_MAX);
+
+    const size_t last = std::min(changed.last, fixedTimeWidth);
+    if (changed.first < last) {
+        std::copy(time.begin() + static_cast<std::ptrdiff_t>(changed.first),
+                  time.begin() + static_cast<std::ptrdiff_t>(last),
+                  fixedColumns.begin() + static_cast<std::ptrdiff_t>(*fixedTimeStart + changed.first));
     }
-    
-    return rendered;
+}
+
+void Display::composeFrame(Framebuffer& frame)
+{
+    frame = fixedColumns;
+    scrollStrip.blit(frame.data() + windowStart, static_cast<size_t>(scrollOffset));
 }
 
 void Display::setScrolling(Scrolling direction)
 {
     scrollOffset = 0;
+    scrollPosition = 0.0;
     scrollDelayTimer = 0;
 
     if (direction == Scrolling::RESET)
     {
+        requestFrame();
         return;
     }
 
     scrollDirection = direction;
+    requestFrame();
+}
+
+void Display::setRefreshRate(int hz)
+{
+    if (hz < 1 || hz > MAX_REFRESH_RATE) {
+        WARN_LOG("Refresh rate " << hz << " Hz is out of range, using " << std::clamp(hz, 1, MAX_REFRESH_RATE) << " Hz");
+    }
+    refreshRate = std::clamp(hz, 1, MAX_REFRESH_RATE);
+}
+
+int Display::getRefreshRate() const
+{
+    return refreshRate;
+}
+
+void Display::setScrollSpeed(double columnsPerSecond)
+{
+    scrollSpeed = columnsPerSecond > 0.0 ? columnsPerSecond : SCROLL_SPEED;
 }
 
 void Display::setAlignment(Alignment alignment)
 {
     this->alignment = alignment;
     dirty = true;  // Trigger buffer recreation to apply alignment change
+    requestFrame();
 }
 
 Alignment Display::getAlignment() const
@@ -374,6 +463,7 @@ Alignment Display::getAlignment() const
 void Display::forceUpdate()
 {
     dirty = true;  // Force buffer recreation on next prepare() call
+    requestFrame();
 }
 
 size_t Display::calculateCenterOffset(size_t contentSize, size_t availableSpace) const
@@ -384,34 +474,10 @@ size_t Display::calculateCenterOffset(size_t contentSize, size_t availableSpace)
     return (availableSpace - contentSize) / 2;
 }
 
-void Display::renderContentToBuffer(std::array<uint8_t, X_MAX>& buffer, const std::vector<uint8_t>& content, 
-                                   size_t startPos, size_t maxPos) const
-{
-    size_t pos = startPos;
-    for (size_t i = static_cast<size_t>(scrollOffset); pos < maxPos && i < content.size(); ++i, ++pos)
-    {
-        buffer[pos] = content.at(i);
-    }
-}
-
-size_t Display::addTimeDivider(std::array<uint8_t, X_MAX>& buffer, size_t pos) const
-{
-    if (show_time_divider && pos < X_MAX) {
-        // Add vertical divider line (all bits set for full height)
-        buffer[pos++] = 0xFF;  // Vertical divider
-        
-        // Add 1 pixel gap before text when not actively scrolling
-        if (pos < X_MAX && scrollOffset == 0) {
-            buffer[pos++] = 0;  // 1 pixel gap before text starts
-        }
-    }
-    return pos;
-}
-
 void Display::showText(std::string text)
 {
-    renderedText = font::FontCache::renderStringOptimized(text);
-    renderedTextSize = this->renderedText.size();
+    renderedText = font::LazyText(std::move(text));
+    renderedTextSize = renderedText.width();
 
     setScrolling(Scrolling::RESET);
     dirty = true;
@@ -430,6 +496,7 @@ void Display::show(
     
     if (timeFormat.has_value()) {
         timeNeedsUpdate = true;
+        dirty = true;
         
         if (text.has_value()) {
             mode = Mode::TIME_AND_TEXT;
@@ -438,18 +505,25 @@ void Display::show(
         } else {
             mode = Mode::TIME;
             this->timeFormat = timeFormat.value().empty() ? TIME_FORMAT_LONG : timeFormat.value();
-            renderedText.clear();
+            renderedText = font::LazyText();
             renderedTextSize = 0;
         }
+
+        // Compiled once here rather than parsed every second
+        if (timeText.format() != this->timeFormat) {
+            timeText.setFormat(this->timeFormat);
+        }
     } else {
         mode = Mode::TEXT;
         showText(text.has_value() ? text.value() : "");
     }
 
     if (transition_type != transition::Type::NONE) {
-        auto newBuffer = createDisplayBufferOptimized(renderTimeOptimized());
+        renderTime();
+        layoutContent(timeText.columns());
+        composeFrame(nextBuffer);
         transition_manager->setCurrentBuffer(displayBuffer);
-        transition_manager->startTransition(newBuffer, transition_type, duration);
+        transition_manager->startTransition(nextBuffer, transition_type, duration);
     }
     
     // Invoke display state callback if set
@@ -458,6 +532,8 @@ void Display::show(
         std::string timeFormatValue = timeFormat.value_or("");
         displayStateCallback(textValue, timeFormatValue, currentBrightness);
     }
+
+    requestFrame();
 }
 
 // Transition support methods
@@ -478,11 +554,12 @@ bool Display::isTransitioning() const
 void Display::startPongGame()
 {
     if (!pong_game) {
-        pong_game = std::make_unique<pong::PongGame>();
+        pong_game = std::make_unique<pong::PongGame>(displayWidth);
     }
     pong_game->start();
     pong_mode = true;
     dirty = true;
+    requestFrame();
     DEBUG_LOG("Pong game started");
 }
 
@@ -493,6 +570,7 @@ void Display::stopPongGame()
     }
     pong_mode = false;
     dirty = true;
+    requestFrame();
     DEBUG_LOG("Pong game stopped");
     
     // Notify sequence system that pong stopped so it can refresh display
@@ -7,17 +7,24 @@
 #include <vector>
 #include <functional>
 #include <memory>
-
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include "font.hpp"
+#include "geometry.hpp"
+#include "scroll_strip.hpp"
+#include "time_text.hpp"
 #include "timer.hpp"
 #include "transition.hpp"
 
-#define X_MAX 128
-
 // Forward declaration to avoid circular dependency
 namespace pong { class PongGame; }
 
 #define SCROLL_DELAY 2.0   // Seconds
-#define REFRESH_RATE 15  // Hz
+#define SCROLL_SPEED 15.0  // Columns per second
+#define REFRESH_RATE 15  // Hz, default
+#define MAX_REFRESH_RATE 60  // Hz
 
 #define DEFAULT_BRIGHTNESS 8
 
@@ -47,12 +54,38 @@ enum Alignment
     CENTER,
 };
 
+// Why the frame loop woke up
+enum class FrameReason
+{
+    NONE,
+    ANIMATION,  // scrolling, transition or pong running at the refresh rate
+    CLOCK,      // next second boundary while a time format is shown
+    CONTENT,    // content or settings changed
+};
+
+struct FrameStats
+{
+    uint64_t animation_wakeups = 0;
+    uint64_t clock_wakeups = 0;
+    uint64_t content_wakeups = 0;
+
+    // Time spent preparing and writing each frame, the budget is one refresh period
+    uint64_t frames = 0;
+    uint64_t frames_over_budget = 0;
+    std::chrono::nanoseconds average_frame_time{0};
+    std::chrono::nanoseconds worst_frame_time{0};
+};
+
 using DisplayStateCallback = std::function<void(const std::string& text, const std::string& time_format, int brightness)>;
 
 class Display
 {
 public:
+    /**
+     * @param width Display width in columns, see Geometry::width()
+     */
     Display(
+        size_t width,
         std::function<void()> preUpdate,
         std::function<void()> postUpdate,
         DisplayStateCallback stateCallback = nullptr,
@@ -62,6 +95,9 @@ public:
 
     virtual void setBrightness(int brightness) = 0;
     void setScrolling(Scrolling direction);
+    void setScrollSpeed(double columnsPerSecond);  // SCROLL_SPEED if not positive
+    void setRefreshRate(int hz);                   // clamped to 1..MAX_REFRESH_RATE
+    int getRefreshRate() const;
     void setAlignment(Alignment alignment);
     Alignment getAlignment() const;
     void forceUpdate();
@@ -90,55 +126,81 @@ public:
     // Callback for when pong stops (to refresh sequence display)
     void setPongStopCallback(std::function<void()> callback);
 
+    // Frame loop wakeups per reason, the loop idles while nothing animates
+    FrameStats getFrameStats() const;
+
 protected:
-    std::array<uint8_t, X_MAX> displayBuffer{0};
+    const size_t displayWidth;
+    Framebuffer displayBuffer;
     size_t renderedTextSize = 0;
     int scrollOffset = 0;
     Scrolling scrollDirection = Scrolling::ENABLED;
     int currentBrightness = DEFAULT_BRIGHTNESS;
     
+    // Advances scrolling and transitions by deltaTime seconds, one refresh period by default
     bool prepare();
+    bool prepare(double deltaTime);
 
 private:
     virtual void update() = 0;
 
+    // Adaptive frame clock
+    void runFrame();
+    void scheduleNextFrame(std::chrono::nanoseconds work);
+    void requestFrame();
+
     void showText(std::string text);
-    std::array<uint8_t, X_MAX> createDisplayBuffer(std::vector<uint8_t> time);
-    std::array<uint8_t, X_MAX> createDisplayBufferOptimized(const std::vector<uint8_t>& time);
-    std::vector<uint8_t> renderTime();
-    const std::vector<uint8_t>& renderTimeOptimized();
+    // Renders the time once per second, returns the columns of timeText that changed
+    ColumnRange renderTime();
     
-    // Helper methods for cleaner buffer creation
     size_t calculateCenterOffset(size_t contentSize, size_t availableSpace) const;
-    void renderContentToBuffer(std::array<uint8_t, X_MAX>& buffer, const std::vector<uint8_t>& content, 
-                              size_t startPos, size_t maxPos) const;
-    size_t addTimeDivider(std::array<uint8_t, X_MAX>& buffer, size_t pos) const;
-    
-    // Mode-specific buffer creation methods
-    std::array<uint8_t, X_MAX> createTimeOnlyBuffer(std::array<uint8_t, X_MAX>& rendered, const std::vector<uint8_t>& time);
-    std::array<uint8_t, X_MAX> createTextOnlyBuffer(std::array<uint8_t, X_MAX>& rendered);
-    std::array<uint8_t, X_MAX> createTimeAndTextBuffer(std::array<uint8_t, X_MAX>& rendered, const std::vector<uint8_t>& time);
-    
-    // Consolidated buffer creation method
-    std::array<uint8_t, X_MAX> createBufferWithContent(std::array<uint8_t, X_MAX>& rendered, 
-                                                    const std::vector<uint8_t>* timeContent,
-                                                    const std::vector<uint8_t>* textContent,
-                                                    bool addDivider);
+
+    // Lays out the current content once, splitting what scrolls from what does not
+    void layoutContent(const std::vector<uint8_t>& time);
+    void layoutText(size_t pos, size_t gap);
+
+    // Copies the changed time columns into the layout, or lays it out again if they moved
+    void patchTime(ColumnRange changed);
+
+    // Fixed columns plus the scroll window at scrollOffset
+    void composeFrame(Framebuffer& frame);
 
     Mode mode = Mode::TIME;
-    std::vector<uint8_t> renderedText;
+    font::LazyText renderedText;   // columns are rendered as they scroll into view
     std::string timeFormat = TIME_FORMAT_LONG;
     double scrollDelayTimer = 0.0;
+    double scrollPosition = 0.0;    // fractional scrollOffset
+    double scrollSpeed = SCROLL_SPEED;
+    std::atomic<int> refreshRate{REFRESH_RATE};
     bool dirty = true;
     Alignment alignment = Alignment::LEFT;
     
-    // Caching for performance optimization
-    std::vector<uint8_t> cachedRenderedTime;
+    // Time fields are redrawn only when their text changes
+    TimeText timeText;
+    LocalTime localTime;
     std::time_t lastTimeRendered = 0;
-    std::string lastTimeFormat;
     bool timeNeedsUpdate = true;
 
-    std::vector<std::unique_ptr<timer::Timer>> timers;
+    // Content layout, rebuilt only when the content or the time changes
+    Framebuffer fixedColumns;
+    ScrollStrip scrollStrip;
+    size_t windowStart = 0;     // display column the scroll window starts at
+    std::optional<size_t> fixedTimeStart;  // display column of the time if it does not scroll
+    size_t fixedTimeWidth = 0;  // time columns shown there
+    Framebuffer nextBuffer;
+
+    std::unique_ptr<timer::Timer> frameTimer;
+    std::mutex frameMutex;
+    FrameReason nextFrameReason = FrameReason::NONE;
+    bool scrollActive = false;
+    std::atomic<uint64_t> animationWakeups{0};
+    std::atomic<uint64_t> clockWakeups{0};
+    std::atomic<uint64_t> contentWakeups{0};
+    std::chrono::steady_clock::time_point lastAnimationFrame;
+    std::atomic<uint64_t> frames{0};
+    std::atomic<uint64_t> framesOverBudget{0};
+    std::atomic<int64_t> frameTimeTotal{0};
+    std::atomic<int64_t> frameTimeWorst{0};
 
     std::function<void()> preUpdate;
     std::function<void()> postUpdate;
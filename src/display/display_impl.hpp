@@ -1,3 +1,7 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+
 #include "display.hpp"
 
 namespace display
@@ -7,6 +11,7 @@ class DisplayImpl : public Display
 {
 public:
     DisplayImpl(
+        const Geometry& geometry,
         std::function<void()> preUpdate,
         std::function<void()> postUpdate,
         DisplayStateCallback stateCallback,
@@ -18,9 +23,10 @@ public:
 
 private:
     void update();
+    void writeFrame(const Framebuffer& frame);
     
-    // Track current brightness for restoration after reinitialization
-    int currentBrightness = DEFAULT_BRIGHTNESS;
+    // Track current brightness for restoration after reinitialization, read by the output thread
+    std::atomic<int> currentBrightness = DEFAULT_BRIGHTNESS;
 };
 
 } // namespace display
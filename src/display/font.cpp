@@ -1,126 +1,160 @@
+#include <algorithm>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <cstring>
 #include <vector>
-#include <unordered_map>
 #include <cstdint>
 
 #include "font_generated.hpp"
 #include "font.hpp"
+#include "utf8_converter.hpp"
 
 
-static const font::GlyphData* fontCharacter(char c)
+namespace font
 {
-    return font::getGlyph(c);
-}
 
-static std::vector<uint8_t> renderChar(char c)
+// Glyph index of a code point, or nullopt if the font has no glyph for it
+static std::optional<char> glyphIndex(char32_t code_point)
 {
-    const auto* glyph = fontCharacter(c);
-    if (!glyph) {
-        return {0}; // Return single empty column if glyph not found
-    }
-    
-    std::vector<uint8_t> rendered;
-    
-    // Copy the actual glyph columns
-    for (uint8_t column : *glyph) {
-        rendered.push_back(column);
+    if (code_point < 0x100)
+    {
+        const char c = static_cast<char>(code_point);
+        return getGlyph(c).defined ? std::optional<char>(c) : std::nullopt;
     }
 
-    // empty row after glyph
-    rendered.push_back(0);
-
-    return rendered;
+    auto it = std::lower_bound(extraGlyphs.begin(), extraGlyphs.end(), code_point,
+                               [](const ExtraGlyph& glyph, char32_t value) { return glyph.code_point < value; });
+    if (it == extraGlyphs.end() || it->code_point != code_point)
+    {
+        return std::nullopt;
+    }
+    return static_cast<char>(it->index);
 }
 
-namespace font
-{
-
-std::vector<uint8_t> renderString(std::string text)
+std::string toGlyphs(const std::string& utf8)
 {
-    std::vector<uint8_t> rendered;
+    std::string glyphs;
+    glyphs.reserve(utf8.size());
 
-    for (auto it = text.begin(); it < text.end(); ++it)
+    for (size_t pos = 0; pos < utf8.size();)
     {
-        auto glyph = renderChar(*it);
-        rendered.insert(rendered.end(), glyph.begin(), glyph.end());
+        const char32_t code_point = utf8::decode(utf8, pos);
+        if (code_point < 0x20 || (code_point >= 0x7F && code_point < 0xA0))
+        {
+            glyphs += ' ';
+        }
+        else if (auto index = glyphIndex(code_point))
+        {
+            glyphs += *index;
+        }
+        else if (const char* latin1 = utf8::transliterate(code_point))
+        {
+            for (; *latin1; ++latin1)
+            {
+                glyphs += glyphIndex(static_cast<uint8_t>(*latin1)).value_or('?');
+            }
+        }
+        else
+        {
+            glyphs += '?';
+        }
     }
 
-    return rendered;
+    return glyphs;
 }
 
-// Static member definitions
-std::unordered_map<char, std::vector<uint8_t>> FontCache::glyphCache;
-std::unordered_map<std::string, std::vector<uint8_t>> FontCache::stringCache;
-bool FontCache::initialized = false;
-
-void FontCache::initializeCache()
+std::string fromGlyphs(const std::string& glyphs)
 {
-    if (initialized) return;
-    
-    // Pre-cache common characters to avoid runtime lookups
-    const char* commonChars = " 0123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz.,!?-";
-    
-    for (const char* c = commonChars; *c; ++c)
+    std::string utf8;
+    utf8.reserve(glyphs.size() * 2);
+
+    for (char c : glyphs)
     {
-        renderCharCached(*c);  // This will populate the cache
+        const auto index = static_cast<uint8_t>(c);
+        auto it = std::find_if(extraGlyphs.begin(), extraGlyphs.end(),
+                               [index](const ExtraGlyph& glyph) { return glyph.index == index; });
+        utf8::encode(it != extraGlyphs.end() ? it->code_point : index, utf8);
     }
-    
-    initialized = true;
+
+    return utf8;
 }
 
-const std::vector<uint8_t>& FontCache::renderCharCached(char c)
+// Copies the glyph and its blank column, returns the columns written
+static size_t renderGlyph(char c, uint8_t* destination)
 {
-    auto it = glyphCache.find(c);
-    if (it != glyphCache.end())
-    {
-        return it->second;  // Cache hit
-    }
-    
-    // Cache miss - render and store
-    std::vector<uint8_t> rendered = renderChar(c);
-    auto result = glyphCache.emplace(c, std::move(rendered));
-    return result.first->second;
+    const auto& glyph = getGlyph(c);
+    std::memcpy(destination, fontAtlas + glyph.offset, glyph.advance);
+    return glyph.advance;
 }
 
-std::vector<uint8_t> FontCache::renderStringOptimized(const std::string& text)
+size_t stringWidth(std::string_view text)
 {
-    if (!initialized)
-    {
-        initializeCache();
-    }
-    
-    // Check string cache first for common strings (like time formats)
-    auto stringIt = stringCache.find(text);
-    if (stringIt != stringCache.end())
+    size_t width = 0;
+    for (char c : text)
     {
-        return stringIt->second;  // Full string cache hit
+        width += getGlyph(c).advance;
     }
-    
-    // Render using cached characters
-    std::vector<uint8_t> rendered;
-    rendered.reserve(text.length() * 6);  // Estimate: ~6 pixels per character average
-    
+    return width;
+}
+
+size_t renderString(std::string_view text, uint8_t* destination)
+{
+    uint8_t* column = destination;
     for (char c : text)
     {
-        const auto& glyph = renderCharCached(c);
-        rendered.insert(rendered.end(), glyph.begin(), glyph.end());
+        column += renderGlyph(c, column);
     }
-    
-    // Cache the result if it's a reasonable size (avoid caching huge strings)
-    if (text.length() <= 32 && stringCache.size() < 100)
+    return static_cast<size_t>(column - destination);
+}
+
+std::vector<uint8_t> renderString(const std::string& text)
+{
+    std::vector<uint8_t> rendered(stringWidth(text));
+    renderString(text, rendered.data());
+    return rendered;
+}
+
+LazyText::LazyText(std::string text)
+    : characters(std::move(text))
+{
+    block_starts.reserve(characters.size() / GLYPHS_PER_BLOCK + 1);
+    for (size_t i = 0; i < characters.size(); ++i)
     {
-        stringCache[text] = rendered;
+        if (i % GLYPHS_PER_BLOCK == 0)
+        {
+            block_starts.push_back(total_width);
+        }
+        total_width += getGlyph(characters[i]).advance;
     }
-    
-    return rendered;
 }
 
-void FontCache::clearCache()
+void LazyText::render(size_t first, size_t count, uint8_t* destination) const
 {
-    glyphCache.clear();
-    stringCache.clear();
-    initialized = false;
+    size_t written = 0;
+
+    if (first < total_width)
+    {
+        // Last block starting at or before the first column, then the glyph within it
+        auto block = std::upper_bound(block_starts.begin(), block_starts.end(), first) - block_starts.begin() - 1;
+        size_t index = static_cast<size_t>(block) * GLYPHS_PER_BLOCK;
+        size_t column = block_starts[static_cast<size_t>(block)];
+        while (column + getGlyph(characters[index]).advance <= first)
+        {
+            column += getGlyph(characters[index++]).advance;
+        }
+
+        size_t skip = first - column;
+        for (; index < characters.size() && written < count; ++index, skip = 0)
+        {
+            const auto& glyph = getGlyph(characters[index]);
+            const size_t size = std::min<size_t>(glyph.advance - skip, count - written);
+            std::memcpy(destination + written, fontAtlas + glyph.offset + skip, size);
+            written += size;
+        }
+    }
+
+    std::memset(destination + written, 0, count - written);
 }
 
 } // namespace font
\ No newline at end of file
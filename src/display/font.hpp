@@ -1,27 +1,64 @@
+#pragma once
+
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
+#include <cstddef>
 #include <cstdint>
 
 namespace font
 {
 
-std::vector<uint8_t> renderString(std::string text);
+/**
+ * @brief Decodes UTF-8 text straight to the glyph indices the rest of the font takes
+ *
+ * Latin-1 characters index their glyph directly, the few glyphs beyond
+ * Latin-1 (arrows, box drawing, weather) are found in the generated sparse
+ * index. Anything else the font lacks is transliterated, e.g. "ss" for U+00DF,
+ * or shown as '?'. Control characters become spaces.
+ */
+std::string toGlyphs(const std::string& utf8);
+
+// UTF-8 text of glyph indices, the reverse of toGlyphs()
+std::string fromGlyphs(const std::string& glyphs);
+
+// Columns of the text, each glyph followed by a blank column
+std::vector<uint8_t> renderString(const std::string& text);
 
-// Optimized font rendering with caching
-class FontCache
+// Writes the stringWidth() columns of the text, returns how many that is
+size_t renderString(std::string_view text, uint8_t* destination);
+
+// Columns renderString() produces for the text
+size_t stringWidth(std::string_view text);
+
+/**
+ * @brief Text that renders its columns only when they are asked for
+ *
+ * Keeps the characters, which index the font, and the column every block of
+ * GLYPHS_PER_BLOCK glyphs starts at, a sparse prefix sum of the glyph widths.
+ * Finding a column is a binary search over the blocks plus a walk through at
+ * most one block, so rendering a window costs the same anywhere in the text
+ * and a long text takes about one byte per character instead of one per column.
+ */
+class LazyText
 {
-private:
-    static std::unordered_map<char, std::vector<uint8_t>> glyphCache;
-    static std::unordered_map<std::string, std::vector<uint8_t>> stringCache;
-    static bool initialized;
-    
-    static void initializeCache();
-    static const std::vector<uint8_t>& renderCharCached(char c);
-    
 public:
-    static std::vector<uint8_t> renderStringOptimized(const std::string& text);
-    static void clearCache();
+    LazyText() = default;
+    explicit LazyText(std::string text);
+
+    // Columns of the whole text, as renderString() would produce
+    size_t width() const { return total_width; }
+    bool empty() const { return total_width == 0; }
+
+    // Renders count columns starting at first, columns past the end are blank
+    void render(size_t first, size_t count, uint8_t* destination) const;
+
+private:
+    static constexpr size_t GLYPHS_PER_BLOCK = 32;
+
+    std::string characters;
+    std::vector<size_t> block_starts;
+    size_t total_width = 0;
 };
 
 } // namespace font
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+
+#include "geometry.hpp"
+#include "log_util.hpp"
+
+namespace display
+{
+
+Geometry::Geometry(size_t panel_count, size_t panel_width, bool flip)
+    : panel_count(panel_count),
+      panel_width(panel_width),
+      flip(flip)
+{
+}
+
+size_t Geometry::blockOf(size_t panel) const
+{
+    return panel_order.empty() ? panel : panel_order[panel];
+}
+
+size_t Geometry::firstColumnOf(size_t panel) const
+{
+    // Upside down, the leftmost block ends up on the right
+    const size_t block = blockOf(panel);
+    return (flip ? panel_count - 1 - block : block) * panel_width;
+}
+
+size_t Geometry::firstPanelOf(size_t chain) const
+{
+    size_t first = 0;
+    for (size_t i = 0; i < chain && i < chains.size(); ++i) {
+        first += chains[i];
+    }
+    return first;
+}
+
+size_t Geometry::panelsIn(size_t chain) const
+{
+    return chains.empty() ? panel_count : chains[chain];
+}
+
+std::string Geometry::validate() const
+{
+    std::stringstream error;
+
+    if (panel_count == 0) {
+        error << "at least one panel is required";
+    } else if (std::find(std::begin(SUPPORTED_PANEL_WIDTHS), std::end(SUPPORTED_PANEL_WIDTHS), panel_width)
+               == std::end(SUPPORTED_PANEL_WIDTHS)) {
+        error << "panel width " << panel_width << " is not supported, use 8, 16, 24 or 32";
+    } else if (!cs_pins.empty() && cs_pins.size() != panel_count) {
+        error << cs_pins.size() << " chip select pins given for " << panel_count << " panels";
+    } else if (!chains.empty() && (std::accumulate(chains.begin(), chains.end(), size_t{0}) != panel_count
+                                   || std::count(chains.begin(), chains.end(), size_t{0}) > 0)) {
+        error << "chains must split the " << panel_count << " panels, each with at least one";
+    } else if (!panel_order.empty()) {
+        auto sorted = panel_order;
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t i = 0; i < sorted.size(); ++i) {
+            if (sorted.size() != panel_count || sorted[i] != i) {
+                error << "panel order must list each of the " << panel_count << " panels once";
+                break;
+            }
+        }
+    }
+
+    return error.str();
+}
+
+template <typename T>
+static bool parseList(const char* value, std::vector<T>& list)
+{
+    std::stringstream stream(value);
+    std::string item;
+
+    list.clear();
+    while (std::getline(stream, item, ',')) {
+        char* end = nullptr;
+        const long number = std::strtol(item.c_str(), &end, 10);
+        if (item.empty() || *end != '\0' || number < 0) {
+            return false;
+        }
+        list.push_back(static_cast<T>(number));
+    }
+    return !list.empty();
+}
+
+static bool parseCount(const char* value, size_t& count)
+{
+    char* end = nullptr;
+    const long number = std::strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || number <= 0) {
+        return false;
+    }
+    count = static_cast<size_t>(number);
+    return true;
+}
+
+std::optional<Geometry> Geometry::fromEnvironment()
+{
+    Geometry geometry;
+
+    const char* env_panels = std::getenv("DISPLAY_PANELS");
+    const char* env_panel_width = std::getenv("DISPLAY_PANEL_WIDTH");
+    const char* env_cs_pins = std::getenv("DISPLAY_CS_PINS");
+    const char* env_flip = std::getenv("DISPLAY_FLIP");
+    const char* env_panel_order = std::getenv("DISPLAY_PANEL_ORDER");
+    const char* env_chains = std::getenv("DISPLAY_CHAINS");
+
+    if (env_panels && !parseCount(env_panels, geometry.panel_count)) {
+        ERROR_LOG("Invalid DISPLAY_PANELS: " << env_panels);
+        return std::nullopt;
+    }
+    if (env_panel_width && !parseCount(env_panel_width, geometry.panel_width)) {
+        ERROR_LOG("Invalid DISPLAY_PANEL_WIDTH: " << env_panel_width);
+        return std::nullopt;
+    }
+    if (env_cs_pins && !parseList(env_cs_pins, geometry.cs_pins)) {
+        ERROR_LOG("Invalid DISPLAY_CS_PINS: " << env_cs_pins);
+        return std::nullopt;
+    }
+    if (env_flip) {
+        const std::string flip(env_flip);
+        if (flip != "true" && flip != "false") {
+            ERROR_LOG("Invalid DISPLAY_FLIP: " << env_flip << ", use true or false");
+            return std::nullopt;
+        }
+        geometry.flip = flip == "true";
+    }
+    if (env_panel_order && !parseList(env_panel_order, geometry.panel_order)) {
+        ERROR_LOG("Invalid DISPLAY_PANEL_ORDER: " << env_panel_order);
+        return std::nullopt;
+    }
+    if (env_chains && !parseList(env_chains, geometry.chains)) {
+        ERROR_LOG("Invalid DISPLAY_CHAINS: " << env_chains);
+        return std::nullopt;
+    }
+
+    const auto error = geometry.validate();
+    if (!error.empty()) {
+        ERROR_LOG("Invalid display geometry: " << error);
+        return std::nullopt;
+    }
+
+    return geometry;
+}
+
+std::optional<int> refreshRateFromEnvironment(int default_rate, int max_rate)
+{
+    const char* env_refresh_rate = std::getenv("DISPLAY_REFRESH_RATE");
+    if (!env_refresh_rate) {
+        return default_rate;
+    }
+
+    size_t rate = 0;
+    if (!parseCount(env_refresh_rate, rate) || rate > static_cast<size_t>(max_rate)) {
+        ERROR_LOG("Invalid DISPLAY_REFRESH_RATE: " << env_refresh_rate << ", use 1 to " << max_rate << " Hz");
+        return std::nullopt;
+    }
+    return static_cast<int>(rate);
+}
+
+} // namespace display
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/* Defaults, each can be overridden at startup, see Geometry::fromEnvironment() */
+#define DEFAULT_PANEL_COUNT     4
+#define DEFAULT_PANEL_WIDTH     32
+#define DEFAULT_FLIP_180        true    /* display mounted upside down */
+
+namespace display
+{
+
+// Whole display, one byte per column with the top row in bit 0
+using Framebuffer = std::vector<uint8_t>;
+
+// Panel widths the column loops are specialized for
+inline constexpr size_t SUPPORTED_PANEL_WIDTHS[] = {8, 16, 24, 32};
+
+/**
+ * @brief Layout of the panel chain, loaded once at startup
+ *
+ * Panels are numbered in chain order, which is the order of their chip
+ * selects. panel_order maps each of them to the block of panel_width
+ * columns it shows, counted from the left of the upright display.
+ *
+ * The panels may be split over several independent chains (buses) that are
+ * written in parallel, chains lists how many consecutive panels each has.
+ */
+struct Geometry
+{
+    size_t panel_count = DEFAULT_PANEL_COUNT;
+    size_t panel_width = DEFAULT_PANEL_WIDTH;
+    std::vector<int> cs_pins;           // one per panel, empty for the driver's defaults
+    bool flip = DEFAULT_FLIP_180;
+    std::vector<size_t> panel_order;    // empty for panel i showing block i
+    std::vector<size_t> chains;         // panels per chain, empty for a single chain
+
+    Geometry() = default;
+    Geometry(size_t panel_count, size_t panel_width, bool flip = false);
+
+    size_t width() const { return panel_count * panel_width; }
+
+    // Block of columns shown by a panel in chain order
+    size_t blockOf(size_t panel) const;
+
+    // First framebuffer column a panel shows, taking flip into account
+    size_t firstColumnOf(size_t panel) const;
+
+    size_t chainCount() const { return chains.empty() ? 1 : chains.size(); }
+    size_t firstPanelOf(size_t chain) const;
+    size_t panelsIn(size_t chain) const;
+
+    // Empty if the geometry is usable, otherwise what is wrong with it
+    std::string validate() const;
+
+    /**
+     * @brief Defaults overridden by DISPLAY_PANELS, DISPLAY_PANEL_WIDTH,
+     *        DISPLAY_CS_PINS, DISPLAY_FLIP, DISPLAY_PANEL_ORDER and DISPLAY_CHAINS
+     *
+     * Lists are comma separated, e.g. DISPLAY_CS_PINS=8,9,15,16.
+     *
+     * @return nullopt and logs why if a value is malformed or the result is invalid
+     */
+    static std::optional<Geometry> fromEnvironment();
+};
+
+/**
+ * @brief Frame rate while animating, DISPLAY_REFRESH_RATE overrides default_rate
+ *
+ * @return nullopt and logs why if the value is malformed or outside 1..max_rate
+ */
+std::optional<int> refreshRateFromEnvironment(int default_rate, int max_rate);
+
+} // namespace display
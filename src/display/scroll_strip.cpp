@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstring>
+
+#include "scroll_strip.hpp"
+
+namespace display
+{
+
+void ScrollStrip::assign(const std::vector<uint8_t>& content, size_t window, size_t lead)
+{
+    source = nullptr;
+    lead_size = lead;
+    length = lead + content.size();
+    window_size = window;
+    base = 0;
+
+    // Reuses the allocation, strips only grow until the longest content was shown
+    columns.assign(length + window, 0);
+    std::copy(content.begin(), content.end(), columns.begin() + static_cast<std::ptrdiff_t>(lead));
+}
+
+void ScrollStrip::assign(Source content, size_t content_size, size_t window, size_t lead)
+{
+    source = std::move(content);
+    lead_size = lead;
+    length = lead + content_size;
+    window_size = window;
+
+    columns.assign(window + LOOKAHEAD, 0);
+    fill(0);
+}
+
+void ScrollStrip::clear()
+{
+    source = nullptr;
+    columns.clear();
+    base = 0;
+    length = 0;
+    window_size = 0;
+}
+
+void ScrollStrip::fill(size_t offset)
+{
+    base = offset;
+
+    // Blank lead columns, then whatever the source has from there on
+    const size_t blank = std::min(lead_size > offset ? lead_size - offset : 0, columns.size());
+    std::memset(columns.data(), 0, blank);
+    if (blank < columns.size()) {
+        source(offset + blank - lead_size, columns.size() - blank, columns.data() + blank);
+    }
+}
+
+void ScrollStrip::blit(uint8_t* destination, size_t offset)
+{
+    if (window_size == 0) {
+        return;
+    }
+
+    offset = std::min(offset, length);
+    if (source && (offset < base || offset + window_size > base + columns.size())) {
+        fill(offset);
+    }
+    std::memcpy(destination, columns.data() + (offset - base), window_size);
+}
+
+} // namespace display
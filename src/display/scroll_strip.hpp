@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace display
+{
+
+/**
+ * @brief Scrolling content laid out once, each frame is a window into it
+ *
+ * The content is preceded by lead blank columns (alignment, gaps) and
+ * followed by a window's worth of blank columns, so a window at any offset
+ * up to the end of the content is a single memcpy without bounds checks.
+ *
+ * Content from a Source is rendered lazily instead: only the window and
+ * LOOKAHEAD columns after it are held, and rendered again once the window
+ * moves past them, so memory does not grow with the length of the content.
+ */
+class ScrollStrip
+{
+public:
+    // Renders count content columns starting at first, blank past the end of the content
+    using Source = std::function<void(size_t first, size_t count, uint8_t* destination)>;
+
+    static constexpr size_t LOOKAHEAD = 128;
+
+    /**
+     * @param content Columns to scroll
+     * @param window Columns shown at a time
+     * @param lead Blank columns before the content
+     */
+    void assign(const std::vector<uint8_t>& content, size_t window, size_t lead = 0);
+    void assign(Source source, size_t content_size, size_t window, size_t lead = 0);
+    void clear();
+
+    // Lead and content columns, the offset at which the end of the content is in view is size() - window()
+    size_t size() const { return length; }
+    size_t window() const { return window_size; }
+
+    // Content wider than the window needs scrolling to be seen in full
+    bool overflows() const { return length > window_size; }
+
+    // Columns held in memory
+    size_t resident() const { return columns.size(); }
+
+    // Copies window() columns starting at offset, offsets past size() show blank columns
+    void blit(uint8_t* destination, size_t offset);
+
+private:
+    void fill(size_t offset);
+
+    Source source;
+    size_t lead_size = 0;
+    std::vector<uint8_t> columns;   // strip columns from base on
+    size_t base = 0;
+    size_t length = 0;
+    size_t window_size = 0;
+};
+
+} // namespace display
@@ -1,11 +1,13 @@
+#include <algorithm>
 #include <iostream>
 #include <optional>
+#include <vector>
 
 #include "display.hpp"
 #include "sequence.hpp"
 #include "log_util.hpp"
 #include "transition.hpp"
-#include "utf8_converter.hpp"
+#include "font.hpp"
 
 using namespace std::chrono;
 
@@ -16,10 +18,8 @@ SequenceManager::SequenceManager(std::unique_ptr<display::Display> display)
     : m_display(std::move(display))
 {
     setDefaultContent();
-   
-    m_timer = timer::createTimer(TIMER_INTERVAL, [this]() {
-        processSequence();
-    });
+
+    m_timer = std::make_unique<timer::Timer>();
     
     if (m_display) {
         m_display->start();
@@ -91,6 +91,7 @@ void SequenceManager::addSequenceState(const std::string& sequence_id, const Dis
     if (m_sequence.size() == 1 && !m_active) {
         startSequence();
     }
+    scheduleNextEvent();
     
     DEBUG_LOG("Added sequence state with time=" << time << ", ttl=" << ttl << ", id='" << sequence_id << "'");
     DEBUG_LOG("Sequence size = " << m_sequence.size() << ", addSequence");
@@ -116,6 +117,7 @@ void SequenceManager::setSequence(const std::vector<SequenceState>& sequence)
     if (!m_sequence.empty()) {
         startSequence();
     }
+    scheduleNextEvent();
 
     DEBUG_LOG("Sequence size = " << m_sequence.size() << ", setSequence");
 }
@@ -186,12 +188,19 @@ void SequenceManager::clearSequenceById(const std::string& sequence_id)
     if (m_sequence.empty()) {
         stopSequence();
     }
+    scheduleNextEvent();
 }
 
 void SequenceManager::processSequence(bool skip_current)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
+    advanceSequence(skip_current);
+    scheduleNextEvent();
+}
+
+void SequenceManager::advanceSequence(bool skip_current)
+{
     if (!m_active || m_sequence.empty()) {
         return;
     }
@@ -201,6 +210,13 @@ void SequenceManager::processSequence(bool skip_current)
         return;
     }
 
+    // Current state was removed by clearSequenceById, move on right away
+    if (m_current_element->isMarkedForDeletion()) {
+        skip_current = true;
+    }
+
+    eraseExpiredStates();
+
     const auto& sequence_state = m_current_element->getData();
 
     if (isStateExpired(sequence_state)) {
@@ -271,8 +287,72 @@ void SequenceManager::onScrollComplete()
     processSequence(true);
 }
 
+// Drop expired states other than the current one, which advanceSequence handles itself
+void SequenceManager::eraseExpiredStates()
+{
+    auto current_id = m_current_element ? m_current_element->getId() : std::string();
+    std::vector<std::string> expired;
+
+    m_sequence.forEach([&](const std::string& id, const SequenceState& state) {
+        if (id != current_id && isStateExpired(state)) {
+            expired.push_back(id);
+        }
+    });
+
+    for (const auto& id : expired) {
+        DEBUG_LOG("Erasing expired state: " << id);
+        m_sequence.erase(id);
+    }
+}
+
+// Arm the timer for the next point in time where the sequence can change:
+// the end of the current state's display time or the earliest TTL expiry.
+// Scroll completion is reported through onScrollComplete() instead.
+void SequenceManager::scheduleNextEvent()
+{
+    if (!m_active || m_sequence.empty() || !m_current_element) {
+        return;
+    }
+
+    auto now = steady_clock::now();
+    std::optional<steady_clock::time_point> deadline;
+    auto consider = [&deadline](steady_clock::time_point when) {
+        if (!deadline || when < *deadline) {
+            deadline = when;
+        }
+    };
+
+    if (m_current_element->isMarkedForDeletion()) {
+        consider(now);
+    } else if (m_current_element->next() != m_current_element) {
+        // A lone state just keeps showing, only its TTL can end it
+        auto state_time = duration<double>(m_current_element->getData().time);
+        consider(m_state_start_time + duration_cast<steady_clock::duration>(state_time));
+    }
+
+    m_sequence.forEach([&](const std::string&, const SequenceState& state) {
+        if (state.ttl > 0.0) {
+            consider(state.created_at + duration_cast<steady_clock::duration>(duration<double>(state.ttl)));
+        }
+    });
+
+    if (!deadline) {
+        return;
+    }
+
+    auto delay = std::max(*deadline - now, duration_cast<steady_clock::duration>(MIN_EVENT_INTERVAL));
+    m_timer->setTimeout([this]() {
+        processSequence();
+    }, duration_cast<nanoseconds>(delay));
+}
+
 bool SequenceManager::isStateExpired(const SequenceState& state)
 {
+    // A ttl of zero means the state never expires
+    if (state.ttl <= 0.0) {
+        return false;
+    }
+
     auto now = steady_clock::now();
     auto elapsed = duration<double>(now - state.created_at).count();
     return elapsed >= state.ttl;
@@ -353,6 +433,11 @@ bool SequenceManager::isSequenceActive() const
     return m_active && !m_sequence.empty();
 }
 
+uint64_t SequenceManager::getWakeupCount() const
+{
+    return m_timer->getStats().runs;
+}
+
 void SequenceManager::onPongStop()
 {
     DEBUG_LOG("Pong stopped - checking for active sequences to display");
@@ -390,6 +475,7 @@ void SequenceManager::processDisplayState(const std::optional<std::string> seque
     if (state.scrolling.has_value()) {
         m_display->setScrolling(state.scrolling.value());
     }
+    m_display->setScrollSpeed(state.scroll_speed.value_or(SCROLL_SPEED));
     
     if (state.brightness.has_value()) {
         int brightness = state.brightness.value();
@@ -416,16 +502,16 @@ DisplayState parseDisplayStateFromJSON(const nlohmann::json& json)
     try {
         // Handle main content
         if (json.contains("text")) {
-            state.text = utf8::toLatin1(json["text"].get<std::string>());
+            state.text = font::toGlyphs(json["text"].get<std::string>());
             
             if (json.contains("show_time") && json["show_time"].get<bool>()) {
                 state.time_format = json.contains("time_format")
-                    ? utf8::toLatin1(json["time_format"].get<std::string>())
+                    ? font::toGlyphs(json["time_format"].get<std::string>())
                     : "";
             }
         } else if (json.contains("show_time") && json["show_time"].get<bool>()) {
             state.time_format = json.contains("time_format")
-                ? utf8::toLatin1(json["time_format"].get<std::string>())
+                ? font::toGlyphs(json["time_format"].get<std::string>())
                 : "";
         }
 
@@ -450,6 +536,13 @@ DisplayState parseDisplayStateFromJSON(const nlohmann::json& json)
             }
         }
         
+        if (json.contains("scroll_speed")) {
+            double scroll_speed = json["scroll_speed"];
+            if (scroll_speed > 0.0) {
+                state.scroll_speed = scroll_speed;
+            }
+        }
+        
         if (json.contains("brightness")) {
             int brightness = json["brightness"];
             if (brightness >= 0 && brightness <= 15) {
@@ -24,6 +24,7 @@ struct DisplayState {
     // Visual properties
     std::optional<display::Alignment> alignment;
     std::optional<display::Scrolling> scrolling;
+    std::optional<double> scroll_speed;  // Columns per second, SCROLL_SPEED if not given
     std::optional<int> brightness;  // 0-15
     
     // Transition
@@ -83,9 +84,15 @@ public:
     
     // Sequence state checking
     bool isSequenceActive() const;
+
+    // Number of times the sequence timer has woken up
+    uint64_t getWakeupCount() const;
         
 private:
     void processSequence(bool skip_current = false);
+    void advanceSequence(bool skip_current);
+    void eraseExpiredStates();
+    void scheduleNextEvent();
     bool isStateExpired(const SequenceState& state);
     void setDefaultContent();
     void onPongStop(); // Called when pong stops to refresh display
@@ -106,8 +113,9 @@ private:
     transition::Type m_default_transition_type = transition::Type::NONE;
     double m_default_transition_duration = 0.0;
     
+    // Sleeps until the next state change or TTL expiry, rearmed whenever the schedule changes
     std::unique_ptr<timer::Timer> m_timer;
-    static constexpr milliseconds TIMER_INTERVAL = 10ms;
+    static constexpr milliseconds MIN_EVENT_INTERVAL = 10ms;
     
     // Current display state tracking
     int m_current_brightness = DEFAULT_BRIGHTNESS; // Default brightness
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include "time_text.hpp"
+#include "font.hpp"
+
+namespace display
+{
+
+static constexpr const char* weekday_names[] = {
+    "Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+static constexpr const char* month_names[] = {
+    "January", "February", "March", "April", "May", "June",
+    "July", "August", "September", "October", "November", "December"};
+
+const std::tm& LocalTime::at(std::time_t time)
+{
+    if (!valid || time < minute_start || time >= minute_start + 60) {
+        localtime_r(&time, &minute);
+        minute_start = time - minute.tm_sec;
+        minute.tm_sec = 0;
+        valid = true;
+    }
+
+    current = minute;
+    current.tm_sec = static_cast<int>(time - minute_start);
+    return current;
+}
+
+void TimeText::addLiteral(const std::string& text)
+{
+    if (text.empty()) {
+        return;
+    }
+    if (!fields.empty() && fields.back().op == Op::LITERAL) {
+        fields.back().spec += text;
+        return;
+    }
+    fields.emplace_back();
+    fields.back().spec = text;
+}
+
+void TimeText::addConversion(char conversion, std::string spec)
+{
+    // Conversions that are others put together
+    switch (conversion) {
+        case 'T': addConversion('H', "%H"); addLiteral(":"); addConversion('M', "%M"); addLiteral(":"); addConversion('S', "%S"); return;
+        case 'R': addConversion('H', "%H"); addLiteral(":"); addConversion('M', "%M"); return;
+        case 'D': addConversion('m', "%m"); addLiteral("/"); addConversion('d', "%d"); addLiteral("/"); addConversion('y', "%y"); return;
+        case 'F': addConversion('Y', "%Y"); addLiteral("-"); addConversion('m', "%m"); addLiteral("-"); addConversion('d', "%d"); return;
+        case 'n': addLiteral("\n"); return;
+        case 't': addLiteral("\t"); return;
+        default: break;
+    }
+
+    Op op = Op::STRFTIME;
+    if (spec.size() == 2) {
+        switch (conversion) {
+            case 'H': op = Op::HOUR; break;
+            case 'I': op = Op::HOUR_12; break;
+            case 'M': op = Op::MINUTE; break;
+            case 'S': op = Op::SECOND; break;
+            case 'd': op = Op::DAY; break;
+            case 'e': op = Op::DAY_PADDED; break;
+            case 'm': op = Op::MONTH; break;
+            case 'Y': op = Op::YEAR; break;
+            case 'y': op = Op::YEAR_2; break;
+            case 'j': op = Op::DAY_OF_YEAR; break;
+            case 'u': op = Op::WEEKDAY; break;
+            case 'w': op = Op::WEEKDAY_0; break;
+            case 'A': op = Op::WEEKDAY_NAME; break;
+            case 'a': op = Op::WEEKDAY_ABBR; break;
+            case 'B': op = Op::MONTH_NAME; break;
+            case 'b': case 'h': op = Op::MONTH_ABBR; break;
+            case 'p': op = Op::AM_PM; break;
+            default: break;
+        }
+    }
+
+    fields.emplace_back();
+    fields.back().op = op;
+    fields.back().spec = std::move(spec);
+}
+
+void TimeText::setFormat(const std::string& format)
+{
+    time_format = format;
+    fields.clear();
+    valid = false;
+
+    for (size_t i = 0; i < format.size(); ++i) {
+        if (format[i] != '%' || i + 1 == format.size()) {
+            addLiteral(std::string(1, format[i]));
+            continue;
+        }
+        if (format[i + 1] == '%') {
+            addLiteral("%");
+            ++i;
+            continue;
+        }
+
+        // Flags, width and E/O modifiers belong to the conversion that follows them
+        size_t end = i + 1;
+        while (end < format.size() && std::strchr("_-0^#", format[end])) {
+            ++end;
+        }
+        while (end < format.size() && format[end] >= '0' && format[end] <= '9') {
+            ++end;
+        }
+        if (end < format.size() && (format[end] == 'E' || format[end] == 'O')) {
+            ++end;
+        }
+        if (end == format.size()) {
+            addLiteral(format.substr(i));
+            break;
+        }
+
+        addConversion(format[end], format.substr(i, end + 1 - i));
+        i = end;
+    }
+}
+
+// Zero padded decimal of at least digits digits
+static size_t formatNumber(int value, size_t digits, char* out, char pad = '0')
+{
+    char reversed[12];
+    size_t length = 0;
+    auto magnitude = static_cast<unsigned>(value < 0 ? -value : value);
+    do {
+        reversed[length++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    while (length < digits) {
+        reversed[length++] = pad;
+    }
+
+    size_t written = 0;
+    if (value < 0) {
+        out[written++] = '-';
+    }
+    while (length > 0) {
+        out[written++] = reversed[--length];
+    }
+    return written;
+}
+
+static size_t formatName(const char* const* names, int count, int index, size_t length, char* out)
+{
+    if (index < 0 || index >= count) {
+        out[0] = '?';
+        return 1;
+    }
+    const char* name = names[index];
+    length = std::min(length, std::strlen(name));
+    std::memcpy(out, name, length);
+    return length;
+}
+
+size_t TimeText::formatField(const Field& field, const std::tm& time, char* out)
+{
+    switch (field.op) {
+        case Op::LITERAL: return 0;
+        case Op::HOUR: return formatNumber(time.tm_hour, 2, out);
+        case Op::HOUR_12: return formatNumber(time.tm_hour % 12 == 0 ? 12 : time.tm_hour % 12, 2, out);
+        case Op::MINUTE: return formatNumber(time.tm_min, 2, out);
+        case Op::SECOND: return formatNumber(time.tm_sec, 2, out);
+        case Op::DAY: return formatNumber(time.tm_mday, 2, out);
+        case Op::DAY_PADDED: return formatNumber(time.tm_mday, 2, out, ' ');
+        case Op::MONTH: return formatNumber(time.tm_mon + 1, 2, out);
+        case Op::YEAR: return formatNumber(time.tm_year + 1900, 1, out);
+        case Op::YEAR_2: return formatNumber((time.tm_year + 1900) % 100, 2, out);
+        case Op::DAY_OF_YEAR: return formatNumber(time.tm_yday + 1, 3, out);
+        case Op::WEEKDAY: return formatNumber(time.tm_wday == 0 ? 7 : time.tm_wday, 1, out);
+        case Op::WEEKDAY_0: return formatNumber(time.tm_wday, 1, out);
+        case Op::WEEKDAY_NAME: return formatName(weekday_names, 7, time.tm_wday, MAX_FIELD_TEXT, out);
+        case Op::WEEKDAY_ABBR: return formatName(weekday_names, 7, time.tm_wday, 3, out);
+        case Op::MONTH_NAME: return formatName(month_names, 12, time.tm_mon, MAX_FIELD_TEXT, out);
+        case Op::MONTH_ABBR: return formatName(month_names, 12, time.tm_mon, 3, out);
+        case Op::AM_PM: std::memcpy(out, time.tm_hour < 12 ? "AM" : "PM", 2); return 2;
+        case Op::STRFTIME: break;
+    }
+
+    // The spec is a single conversion split off the format by setFormat()
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    return std::strftime(out, MAX_FIELD_TEXT, field.spec.c_str(), &time);
+#pragma GCC diagnostic pop
+}
+
+ColumnRange TimeText::render(const std::tm& time)
+{
+    ColumnRange changed{rendered.size(), 0};
+    const size_t previous_width = rendered.size();
+    bool shifted = !valid;   // every field from here on moved and is redrawn
+    size_t column = 0;
+
+    for (auto& field : fields) {
+        std::string_view text = field.spec;
+        if (field.op != Op::LITERAL) {
+            char buffer[MAX_FIELD_TEXT];
+            const size_t length = formatField(field, time, buffer);
+            if (!shifted && length == field.length && std::memcmp(buffer, field.text, length) == 0) {
+                column += field.width;
+                continue;
+            }
+            std::memcpy(field.text, buffer, length);
+            field.length = length;
+            text = std::string_view(field.text, length);
+        } else if (!shifted) {
+            column += field.width;
+            continue;
+        }
+
+        const size_t width = font::stringWidth(text);
+        if (width != field.width || column != field.first) {
+            shifted = true;
+        }
+        if (rendered.size() < column + width) {
+            rendered.resize(column + width);
+        }
+        font::renderString(text, rendered.data() + column);
+
+        changed.first = std::min(changed.first, column);
+        changed.last = column + width;
+        field.first = column;
+        field.width = width;
+        column += width;
+    }
+
+    if (shifted) {
+        rendered.resize(column);
+        changed.first = std::min(changed.first, column);
+        changed.last = std::max(column, previous_width);
+    }
+    valid = true;
+
+    return changed;
+}
+
+} // namespace display
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace display
+{
+
+// Columns [first, last) of a rendering
+struct ColumnRange
+{
+    size_t first = 0;
+    size_t last = 0;
+
+    bool empty() const { return first >= last; }
+};
+
+/**
+ * @brief Local time that calls localtime_r() only once per minute
+ *
+ * Time zone offsets and daylight saving changes fall on whole minutes, so
+ * within a minute the local time only differs in its seconds.
+ */
+class LocalTime
+{
+public:
+    const std::tm& at(std::time_t time);
+
+private:
+    std::time_t minute_start = 0;
+    bool valid = false;
+    std::tm minute{};
+    std::tm current{};
+};
+
+/**
+ * @brief Rendered time that only redraws the fields that changed
+ *
+ * The format is compiled once into a program of literal text and field
+ * conversions, each a field that remembers its text and the columns it was
+ * drawn at. Common strftime conversions (C locale) are formatted directly,
+ * anything else, like flags or E/O modifiers, is left to strftime(). A new
+ * time formats every field into a stack buffer and redraws only those whose
+ * text changed, typically the seconds, unless one of them changes width and
+ * moves everything after it.
+ */
+class TimeText
+{
+public:
+    // Takes effect with the next render(), which redraws every field
+    void setFormat(const std::string& format);
+    const std::string& format() const { return time_format; }
+
+    /**
+     * @brief Renders the time, redrawing only what changed since the last call
+     *
+     * @return Columns that differ from the previous rendering, including
+     *         columns past a shorter new end, empty if nothing changed
+     */
+    ColumnRange render(const std::tm& time);
+
+    const std::vector<uint8_t>& columns() const { return rendered; }
+
+    // Longest text of a single field, e.g. a day name or what strftime() makes of %c
+    static constexpr size_t MAX_FIELD_TEXT = 64;
+
+private:
+    enum class Op : uint8_t
+    {
+        LITERAL,
+        HOUR,           // %H
+        HOUR_12,        // %I
+        MINUTE,         // %M
+        SECOND,         // %S
+        DAY,            // %d
+        DAY_PADDED,     // %e, space padded
+        MONTH,          // %m
+        YEAR,           // %Y
+        YEAR_2,         // %y
+        DAY_OF_YEAR,    // %j
+        WEEKDAY,        // %u, Monday is 1
+        WEEKDAY_0,      // %w, Sunday is 0
+        WEEKDAY_NAME,   // %A
+        WEEKDAY_ABBR,   // %a
+        MONTH_NAME,     // %B
+        MONTH_ABBR,     // %b, %h
+        AM_PM,          // %p
+        STRFTIME,       // anything else
+    };
+
+    struct Field
+    {
+        Op op = Op::LITERAL;
+        std::string spec;       // literal text, or the conversion for STRFTIME
+        char text[MAX_FIELD_TEXT] = {};  // as last rendered
+        size_t length = 0;
+        size_t first = 0;
+        size_t width = 0;
+    };
+
+    void addConversion(char conversion, std::string spec);
+    void addLiteral(const std::string& text);
+
+    // Writes the field's text for the time, returns its length
+    static size_t formatField(const Field& field, const std::tm& time, char* out);
+
+    std::string time_format;
+    std::vector<Field> fields;
+    std::vector<uint8_t> rendered;
+    bool valid = false;         // fields match the rendered columns
+};
+
+} // namespace display
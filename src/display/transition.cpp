@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cmath>
 #include <cstring>
 #include <chrono>
 #include <random>
@@ -11,6 +12,85 @@
 namespace transition
 {
 
+// =============================================================================
+// Frame kernels
+// =============================================================================
+
+// Columns are processed a word at a time, one column per byte of the word
+using Word = uint64_t;
+static constexpr size_t word_columns = sizeof(Word);
+
+// Every byte of the word set to value
+static constexpr Word repeat(uint8_t value)
+{
+    return Word{0x0101010101010101} * value;
+}
+
+static Word loadWord(const uint8_t* columns)
+{
+    Word word;
+    std::memcpy(&word, columns, sizeof(word));
+    return word;
+}
+
+static void storeWord(uint8_t* columns, Word word)
+{
+    std::memcpy(columns, &word, sizeof(word));
+}
+
+// Bits set in mask come from to, the rest from from, then bits set in flip are inverted
+static void blendColumns(uint8_t* out, const uint8_t* from, const uint8_t* to,
+                         const uint8_t* mask, const uint8_t* flip, size_t count)
+{
+    size_t x = 0;
+    for (; x + word_columns <= count; x += word_columns) {
+        const Word m = loadWord(mask + x);
+        storeWord(out + x, ((loadWord(from + x) & ~m) | (loadWord(to + x) & m)) ^ loadWord(flip + x));
+    }
+    for (; x < count; ++x) {
+        out[x] = static_cast<uint8_t>(((from[x] & ~mask[x]) | (to[x] & mask[x])) ^ flip[x]);
+    }
+}
+
+// Columns [first, last) from to, the others from from
+static void revealColumns(uint8_t* out, const uint8_t* from, const uint8_t* to,
+                          size_t count, size_t first, size_t last)
+{
+    last = std::min(last, count);
+    first = std::min(first, last);
+    std::memcpy(out, from, first);
+    std::memcpy(out + first, to + first, last - first);
+    std::memcpy(out + last, from + last, count - last);
+}
+
+// Each column of from moved shift rows towards bit 0 (up) or bit 7 (down), to follows it in
+static void shiftColumns(uint8_t* out, const uint8_t* from, const uint8_t* to,
+                         size_t count, unsigned shift, bool up)
+{
+    // Bits a shift of the whole word carries into the neighbouring column are masked off
+    const unsigned rest = 8 - shift;
+    const unsigned from_shift = up ? shift : 0;
+    const unsigned from_left = up ? 0 : shift;
+    const unsigned to_shift = up ? 0 : rest;
+    const unsigned to_left = up ? rest : 0;
+    const auto from_mask = static_cast<uint8_t>(((0xFFu >> from_shift) << from_left) & 0xFFu);
+    const auto to_mask = static_cast<uint8_t>(((0xFFu >> to_shift) << to_left) & 0xFFu);
+    const Word from_word_mask = repeat(from_mask);
+    const Word to_word_mask = repeat(to_mask);
+
+    size_t x = 0;
+    for (; x + word_columns <= count; x += word_columns) {
+        const Word f = (loadWord(from + x) >> from_shift) << from_left;
+        const Word t = (loadWord(to + x) >> to_shift) << to_left;
+        storeWord(out + x, (f & from_word_mask) | (t & to_word_mask));
+    }
+    for (; x < count; ++x) {
+        const unsigned f = (static_cast<unsigned>(from[x]) >> from_shift) << from_left;
+        const unsigned t = (static_cast<unsigned>(to[x]) >> to_shift) << to_left;
+        out[x] = static_cast<uint8_t>((f & from_mask) | (t & to_mask));
+    }
+}
+
 // =============================================================================
 // TransitionBase Implementation
 // =============================================================================
@@ -20,23 +100,34 @@ TransitionBase::TransitionBase(double duration_seconds)
 {
 }
 
-void TransitionBase::start(const std::array<uint8_t, X_MAX>& from, const std::array<uint8_t, X_MAX>& to)
+void TransitionBase::start(const display::Framebuffer& from, const display::Framebuffer& to)
 {
     source_buffer = from;
     target_buffer = to;
+    source_buffer.resize(target_buffer.size(), 0);
     elapsed_time = 0.0;
+    prepare();
 }
 
-std::array<uint8_t, X_MAX> TransitionBase::update(double delta_time)
+void TransitionBase::update(double delta_time, display::Framebuffer& frame)
 {
     elapsed_time += delta_time;
     double progress = std::min(1.0, elapsed_time / duration);
     
-    if (progress >= 1.0) {
-        return target_buffer;
+    if (progress >= 1.0 || target_buffer.empty()) {
+        frame = target_buffer;
+        return;
     }
     
-    return animate(progress);
+    frame.resize(target_buffer.size());
+    animate(progress, frame);
+}
+
+display::Framebuffer TransitionBase::update(double delta_time)
+{
+    display::Framebuffer frame;
+    update(delta_time, frame);
+    return frame;
 }
 
 void TransitionBase::reset()
@@ -53,7 +144,7 @@ WipeTransition::WipeTransition(Direction dir, double duration)
 {
 }
 
-void WipeTransition::set_wipe_pattern(std::array<uint8_t, X_MAX>& result, uint8_t pattern, size_t pos, short offset)
+void WipeTransition::set_wipe_pattern(display::Framebuffer& result, uint8_t pattern, size_t pos, short offset)
 {
     auto wipe_pos = static_cast<long>(pos) + offset;
     if (wipe_pos < 0 || wipe_pos >= static_cast<long>(result.size())) {
@@ -62,28 +153,24 @@ void WipeTransition::set_wipe_pattern(std::array<uint8_t, X_MAX>& result, uint8_
     result[static_cast<size_t>(wipe_pos)] &= pattern;
 }
 
-std::array<uint8_t, X_MAX> WipeTransition::animate(double progress)
+void WipeTransition::animate(double progress, display::Framebuffer& result)
 {
-    std::array<uint8_t, X_MAX> result = source_buffer;
-    auto wipe_pos = static_cast<size_t>(round(progress * static_cast<double>(X_MAX - 1)));
+    const size_t width = result.size();
+    auto wipe_pos = static_cast<size_t>(round(progress * static_cast<double>(width - 1)));
 
-    for (size_t x = 0; x < X_MAX; ++x) {
-        size_t pos = (direction == Direction::LEFT_TO_RIGHT) ? x : (X_MAX - 1 - x);
-        
-        bool should_reveal = wipe_pos > x;
-        if (should_reveal) {
-            result[pos] = target_buffer[pos];
-        }
+    // The wipe_pos columns behind the wipe show the target
+    if (direction == Direction::LEFT_TO_RIGHT) {
+        revealColumns(result.data(), source_buffer.data(), target_buffer.data(), width, 0, wipe_pos);
+    } else {
+        revealColumns(result.data(), source_buffer.data(), target_buffer.data(), width, width - wipe_pos, width);
     }
 
-    wipe_pos = (direction == Direction::LEFT_TO_RIGHT) ? wipe_pos : (X_MAX - 1 - wipe_pos);
+    wipe_pos = (direction == Direction::LEFT_TO_RIGHT) ? wipe_pos : (width - 1 - wipe_pos);
     set_wipe_pattern(result, 0b11011011, wipe_pos, -2);
     set_wipe_pattern(result, 0b00100100, wipe_pos, -1);
     set_wipe_pattern(result, 0b00000000, wipe_pos);
     set_wipe_pattern(result, 0b00100100, wipe_pos, 1);
     set_wipe_pattern(result, 0b11011011, wipe_pos, 2);
-
-    return result;
 }
 
 // =============================================================================
@@ -104,62 +191,93 @@ void DissolveTransition::generatePixelOrder()
 {
     // Generate random thresholds for each pixel bit
     std::uniform_real_distribution<double> dist(0.0, 1.0);
+    pixel_thresholds.resize(source_buffer.size() * 8);
     for (auto& threshold : pixel_thresholds) {
         threshold = dist(rng);
     }
 }
 
-std::array<uint8_t, X_MAX> DissolveTransition::animate(double progress)
+void DissolveTransition::prepare()
 {
-    std::array<uint8_t, X_MAX> result = source_buffer;
-    
-    for (size_t x = 0; x < X_MAX; ++x) {
-        uint8_t byte_result = 0;
-        uint8_t sparkle_mask = 0;
-        
-        for (size_t bit = 0; bit < 8; ++bit) {
-            size_t pixel_index = x * 8 + bit;
-            double threshold = pixel_thresholds[pixel_index];
-            
-            auto bit_mask = static_cast<uint8_t>(1U << static_cast<unsigned>(bit));
-            
-            if (progress >= threshold) {
-                // Reveal target pixel bit
-                byte_result = static_cast<uint8_t>(byte_result | (target_buffer[x] & bit_mask));
-            } else {
-                // Keep source pixel bit
-                byte_result = static_cast<uint8_t>(byte_result | (source_buffer[x] & bit_mask));
-                
-                // Create sparkle effect for identical content
-                if ((source_buffer[x] & bit_mask) == (target_buffer[x] & bit_mask)) {
-                    // Create a sparkle zone around the transition threshold
-                    double sparkle_zone = 0.1; // 10% of transition time
-                    double distance_to_threshold = std::abs(progress - threshold);
-                    
-                    if (distance_to_threshold < sparkle_zone) {
-                        // Use a sine wave pattern for sparkle intensity
-                        double sparkle_intensity = std::sin(distance_to_threshold * 3.14159 / sparkle_zone);
-                        // Randomly decide if this pixel sparkles based on intensity and threshold
-                        if (sparkle_intensity > 0.5 && 
-                            (static_cast<uint32_t>(pixel_index * 31) % 100) < static_cast<uint32_t>(sparkle_intensity * 100)) {
-                            sparkle_mask |= bit_mask;
-                        }
-                    }
-                }
-            }
+    if (pixel_thresholds.size() != source_buffer.size() * 8) {
+        generatePixelOrder();
+    }
+    buildEvents();
+}
+
+void DissolveTransition::buildEvents()
+{
+    // A pixel sparkles while it is less than the sparkle zone from its threshold
+    // and the sine of that distance is above both 0.5 and its own cut off
+    static constexpr double sparkle_zone = 0.1; // 10% of transition time
+    static constexpr double sparkle_scale = sparkle_zone / 3.14159;
+    static const double pi = std::acos(-1.0);
+
+    events.clear();
+    for (size_t pixel_index = 0; pixel_index < pixel_thresholds.size(); ++pixel_index) {
+        const double threshold = pixel_thresholds[pixel_index];
+        const auto column = static_cast<uint32_t>(pixel_index / 8);
+        const auto bit_mask = static_cast<uint8_t>(1U << (pixel_index % 8));
+        events.push_back({threshold, column, bit_mask, true});
+
+        // Only pixels that look the same before and after sparkle
+        if ((source_buffer[column] & bit_mask) != (target_buffer[column] & bit_mask)) {
+            continue;
         }
-        
-        // Apply sparkle effect (invert sparkle pixels)
-        result[x] = static_cast<uint8_t>(byte_result ^ sparkle_mask);
+
+        // sin(distance * 3.14159 / sparkle_zone) * 100 must reach the pixel's cut off plus one
+        const uint32_t cut_off = static_cast<uint32_t>(pixel_index * 31) % 100;
+        const double intensity = std::max(0.5, (cut_off + 1) / 100.0);
+        const double nearest = std::asin(intensity) * sparkle_scale;
+        const double farthest = std::min(sparkle_zone, (pi - std::asin(intensity)) * sparkle_scale);
+        if (nearest >= farthest) {
+            continue;
+        }
+
+        // On from the farthest distance until just past the nearest
+        events.push_back({threshold - farthest, column, bit_mask, false});
+        events.push_back({std::nextafter(threshold - nearest, 2.0), column, bit_mask, false});
+    }
+
+    std::sort(events.begin(), events.end(),
+              [](const Event& a, const Event& b) { return a.progress < b.progress; });
+    rewind();
+}
+
+void DissolveTransition::rewind()
+{
+    reveal_mask.assign(source_buffer.size(), 0);
+    sparkle_mask.assign(source_buffer.size(), 0);
+    next_event = 0;
+    applied_progress = 0.0;
+}
+
+void DissolveTransition::animate(double progress, display::Framebuffer& result)
+{
+    if (progress < applied_progress) {
+        rewind();
     }
+
+    for (; next_event < events.size() && events[next_event].progress <= progress; ++next_event) {
+        const auto& event = events[next_event];
+        if (event.reveal) {
+            reveal_mask[event.column] |= event.bit_mask;
+        } else {
+            sparkle_mask[event.column] ^= event.bit_mask;
+        }
+    }
+    applied_progress = progress;
     
-    return result;
+    // Revealed bits from the target, the rest from the source, sparkle pixels inverted
+    blendColumns(result.data(), source_buffer.data(), target_buffer.data(),
+                 reveal_mask.data(), sparkle_mask.data(), result.size());
 }
 
 void DissolveTransition::reset()
 {
     TransitionBase::reset();
     generatePixelOrder();
+    buildEvents();
 }
 
 // =============================================================================
@@ -171,28 +289,14 @@ ScrollTransition::ScrollTransition(Direction dir, double duration)
 {
 }
 
-std::array<uint8_t, X_MAX> ScrollTransition::animate(double progress)
+void ScrollTransition::animate(double progress, display::Framebuffer& result)
 {
-    std::array<uint8_t, X_MAX> result{0};
-    
-    int pixel_shift = static_cast<int>(
+    auto pixel_shift = static_cast<unsigned>(
         round(progress * static_cast<double>(DISPLAY_HEIGHT))
     );
 
-    for (size_t x = 0; x < X_MAX; ++x) {
-        uint8_t source_byte = source_buffer[x];
-        uint8_t target_byte = target_buffer[x];
-
-        if (direction == Direction::UP) {
-            result[x] = ((source_byte >> pixel_shift) & 0xFF) | 
-                        ((target_byte << (DISPLAY_HEIGHT - pixel_shift)) & 0xFF);
-        } else {
-            result[x] = ((source_byte << pixel_shift) & 0xFF) | 
-                        ((target_byte >> (DISPLAY_HEIGHT - pixel_shift)) & 0xFF);
-        }
-    }
-    
-    return result;
+    shiftColumns(result.data(), source_buffer.data(), target_buffer.data(), result.size(),
+                 pixel_shift, direction == Direction::UP);
 }
 
 // =============================================================================
@@ -204,31 +308,22 @@ SplitTransition::SplitTransition(Direction dir, double duration)
 {
 }
 
-std::array<uint8_t, X_MAX> SplitTransition::animate(double progress)
+void SplitTransition::animate(double progress, display::Framebuffer& result)
 {
-    std::array<uint8_t, X_MAX> result = source_buffer;
+    const size_t width = result.size();
     
-    auto reveal_width = static_cast<size_t>(progress * static_cast<double>(X_MAX) / 2.0);
+    auto reveal_width = static_cast<size_t>(progress * static_cast<double>(width) / 2.0);
     
-    for (size_t x = 0; x < X_MAX; ++x) {
-        bool should_reveal = false;
-        
-        if (direction == Direction::CENTER_OUT) {
-            // Reveal from center outward
-            size_t center = X_MAX / 2;
-            should_reveal = (x >= (center > reveal_width ? center - reveal_width : 0)) && 
-                           (x < (center + reveal_width));
-        } else {
-            // Reveal from sides inward
-            should_reveal = (x < reveal_width) || (x >= (X_MAX - reveal_width));
-        }
-        
-        if (should_reveal) {
-            result[x] = target_buffer[x];
-        }
+    if (direction == Direction::CENTER_OUT) {
+        // Reveal from center outward
+        size_t center = width / 2;
+        revealColumns(result.data(), source_buffer.data(), target_buffer.data(), width,
+                      center > reveal_width ? center - reveal_width : 0, center + reveal_width);
+    } else {
+        // Reveal from sides inward, the source stays in the middle
+        revealColumns(result.data(), target_buffer.data(), source_buffer.data(), width,
+                      reveal_width, width - reveal_width);
     }
-    
-    return result;
 }
 
 // =============================================================================
@@ -320,12 +415,12 @@ Type TransitionFactory::parseType(const std::string& type_str)
 // TransitionManager Implementation
 // =============================================================================
 
-TransitionManager::TransitionManager(std::function<void(const std::array<uint8_t, X_MAX>&)> display_callback)
+TransitionManager::TransitionManager(std::function<void(const display::Framebuffer&)> display_callback)
     : display_callback(display_callback)
 {
 }
 
-void TransitionManager::startTransition(const std::array<uint8_t, X_MAX>& to_buffer, 
+void TransitionManager::startTransition(const display::Framebuffer& to_buffer, 
                                        Type type, 
                                        double duration)
 {
@@ -360,13 +455,13 @@ bool TransitionManager::update(double delta_time)
         return false;
     }
     
-    auto transition_buffer = current_transition->update(delta_time);
-    display_callback(transition_buffer);
+    current_transition->update(delta_time, transition_frame);
+    display_callback(transition_frame);
     
     return true;
 }
 
-void TransitionManager::setCurrentBuffer(const std::array<uint8_t, X_MAX>& buffer)
+void TransitionManager::setCurrentBuffer(const display::Framebuffer& buffer)
 {
     current_buffer = buffer;
 }
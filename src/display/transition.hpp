@@ -6,8 +6,9 @@
 #include <string>
 #include <random>
 #include <functional>
+#include <vector>
 
-#define X_MAX 128
+#include "geometry.hpp"
 
 namespace transition
 {
@@ -42,17 +43,24 @@ public:
 
     /**
      * @brief Start the transition with source and target states
-     * @param from Previous display buffer state
-     * @param to Target display buffer state  
+     * @param from Previous display buffer state, empty for a blank display
+     * @param to Target display buffer state, any width
      */
-    void start(const std::array<uint8_t, X_MAX>& from, const std::array<uint8_t, X_MAX>& to);
+    void start(const display::Framebuffer& from, const display::Framebuffer& to);
     
+    /**
+     * @brief Update the transition by one frame
+     * @param delta_time Time elapsed since last update (seconds)
+     * @param frame Receives the current transition state, resized to the target width
+     */
+    void update(double delta_time, display::Framebuffer& frame);
+
     /**
      * @brief Update the transition by one frame
      * @param delta_time Time elapsed since last update (seconds)
      * @return Current transition buffer state
      */
-    std::array<uint8_t, X_MAX> update(double delta_time);
+    display::Framebuffer update(double delta_time);
     
     /**
      * @brief Check if transition is complete
@@ -62,7 +70,7 @@ public:
     /**
      * @brief Get the final target state
      */
-    const std::array<uint8_t, X_MAX>& getTargetState() const { return target_buffer; }
+    const display::Framebuffer& getTargetState() const { return target_buffer; }
     
     /**
      * @brief Reset transition to initial state
@@ -70,15 +78,20 @@ public:
     virtual void reset();
 
 protected:
+    /**
+     * @brief Called by start() once both buffers are set, for work that only depends on them
+     */
+    virtual void prepare() {}
+
     /**
      * @brief Pure virtual method for transition-specific animation logic
      * @param progress Normalized progress from 0.0 to 1.0
-     * @return Current frame buffer
+     * @param frame Frame to render, already as wide as the target
      */
-    virtual std::array<uint8_t, X_MAX> animate(double progress) = 0;
+    virtual void animate(double progress, display::Framebuffer& frame) = 0;
 
-    std::array<uint8_t, X_MAX> source_buffer{0};
-    std::array<uint8_t, X_MAX> target_buffer{0};
+    display::Framebuffer source_buffer;
+    display::Framebuffer target_buffer;
     double duration;
     double elapsed_time;
 };
@@ -93,15 +106,21 @@ public:
     WipeTransition(Direction dir = Direction::LEFT_TO_RIGHT, double duration = 1.0);
 
 protected:
-    std::array<uint8_t, X_MAX> animate(double progress) override;
+    void animate(double progress, display::Framebuffer& frame) override;
 
 private:
     Direction direction;
-    void set_wipe_pattern(std::array<uint8_t, X_MAX>& result, uint8_t pattern, size_t pos, short offset = 0);
+    void set_wipe_pattern(display::Framebuffer& result, uint8_t pattern, size_t pos, short offset = 0);
 };
 
 /**
  * @brief Dissolve transition - random pixel-by-pixel reveal
+ *
+ * Every pixel draws the progress at which it is revealed. Pixels that look
+ * the same before and after sparkle (invert) for a while before that. start()
+ * turns both into one list of events sorted by progress, so a frame only
+ * applies the events since the previous frame to the reveal and sparkle
+ * masks and blends the buffers through them.
  */
 class DissolveTransition : public TransitionBase
 {
@@ -109,13 +128,29 @@ public:
     DissolveTransition(double duration = 1.5, uint32_t seed = 0);
 
 protected:
-    std::array<uint8_t, X_MAX> animate(double progress) override;
+    void prepare() override;
+    void animate(double progress, display::Framebuffer& frame) override;
     void reset() override;
 
 private:
+    struct Event
+    {
+        double progress;        // applied once the transition got this far
+        uint32_t column;
+        uint8_t bit_mask;
+        bool reveal;            // sets the bit in reveal_mask, otherwise toggles it in sparkle_mask
+    };
+
     std::mt19937 rng;
-    std::array<double, X_MAX * 8> pixel_thresholds; // 8 bits per byte
+    std::vector<double> pixel_thresholds; // 8 bits per byte, drawn when the width is known
+    std::vector<Event> events;
+    size_t next_event = 0;
+    double applied_progress = 0.0;
+    display::Framebuffer reveal_mask;     // target bits shown
+    display::Framebuffer sparkle_mask;    // bits inverted
     void generatePixelOrder();
+    void buildEvents();
+    void rewind();
 };
 
 /**
@@ -129,7 +164,7 @@ public:
     ScrollTransition(Direction dir = Direction::UP, double duration = 1.0);
 
 protected:
-    std::array<uint8_t, X_MAX> animate(double progress) override;
+    void animate(double progress, display::Framebuffer& frame) override;
 
 private:
     Direction direction;
@@ -147,7 +182,7 @@ public:
     SplitTransition(Direction dir = Direction::CENTER_OUT, double duration = 1.0);
 
 protected:
-    std::array<uint8_t, X_MAX> animate(double progress) override;
+    void animate(double progress, display::Framebuffer& frame) override;
 
 private:
     Direction direction;
@@ -185,7 +220,7 @@ public:
 class TransitionManager
 {
 public:
-    TransitionManager(std::function<void(const std::array<uint8_t, X_MAX>&)> display_callback);
+    TransitionManager(std::function<void(const display::Framebuffer&)> display_callback);
     
     /**
      * @brief Start a transition to a new display state
@@ -193,7 +228,7 @@ public:
      * @param type Transition type to use
      * @param duration Duration in seconds (0 = use default)
      */
-    void startTransition(const std::array<uint8_t, X_MAX>& to_buffer, 
+    void startTransition(const display::Framebuffer& to_buffer, 
                         Type type, 
                         double duration = 0.0);
     
@@ -212,12 +247,13 @@ public:
     /**
      * @brief Set the current display buffer (for transition source)
      */
-    void setCurrentBuffer(const std::array<uint8_t, X_MAX>& buffer);
+    void setCurrentBuffer(const display::Framebuffer& buffer);
 
 private:
     std::unique_ptr<TransitionBase> current_transition;
-    std::array<uint8_t, X_MAX> current_buffer{0};
-    std::function<void(const std::array<uint8_t, X_MAX>&)> display_callback;
+    display::Framebuffer current_buffer;
+    display::Framebuffer transition_frame;  // rendered in place, reused for every frame
+    std::function<void(const display::Framebuffer&)> display_callback;
 };
 
 } // namespace transition
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ht1632
+{
+
+/**
+ * @brief Single-slot mailbox between one producer and one consumer
+ *
+ * Triple buffered: the producer fills its own slot and swaps it into the
+ * shared middle slot, the consumer swaps its slot with the middle one when
+ * a fresh frame is there. Neither side ever blocks the other and a frame
+ * published before the previous one was taken replaces it.
+ */
+template <typename Frame>
+class FrameMailbox
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Producer side: make frame the newest one
+     * @return true if an untaken frame was dropped
+     */
+    bool publish(const Frame& frame)
+    {
+        Slot& slot = m_slots[m_back];
+        slot.frame = frame;
+        slot.published = Clock::now();
+
+        const uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX;
+
+        m_sequence.fetch_add(1, std::memory_order_release);
+        m_sequence.notify_one();
+
+        return (previous & FRESH) != 0;
+    }
+
+    /**
+     * @brief Consumer side: take the newest frame if one arrived since the last take
+     * @return Pointer valid until the next take(), nullptr if nothing new
+     */
+    const Frame* take(Clock::time_point* published = nullptr)
+    {
+        if ((m_middle.load(std::memory_order_acquire) & FRESH) == 0) {
+            return nullptr;
+        }
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX;
+
+        if (published) {
+            *published = m_slots[m_front].published;
+        }
+        return &m_slots[m_front].frame;
+    }
+
+    // Value to pass to wait(), read before checking take()
+    uint32_t sequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+    // Sleep until the sequence moves past seen
+    void wait(uint32_t seen) const { m_sequence.wait(seen, std::memory_order_acquire); }
+
+    // Wake a waiting consumer without publishing, e.g. to shut it down
+    void interrupt()
+    {
+        m_sequence.fetch_add(1, std::memory_order_release);
+        m_sequence.notify_all();
+    }
+
+private:
+    static constexpr uint8_t INDEX = 0x03;
+    static constexpr uint8_t FRESH = 0x04;
+
+    struct Slot
+    {
+        Frame frame{};
+        Clock::time_point published{};
+    };
+
+    std::array<Slot, 3> m_slots;
+    std::atomic<uint8_t> m_middle{1};
+    std::atomic<uint32_t> m_sequence{0};
+    uint8_t m_back = 0;     // owned by the producer
+    uint8_t m_front = 2;    // owned by the consumer
+};
+
+} // namespace ht1632
@@ -0,0 +1,77 @@
+#include "frame_output.hpp"
+
+using namespace std::chrono;
+
+namespace ht1632
+{
+
+FrameOutput::FrameOutput(Sink sink)
+    : m_sink(std::move(sink)),
+      m_thread([this] { run(); })
+{
+}
+
+FrameOutput::~FrameOutput()
+{
+    stop();
+}
+
+void FrameOutput::submit(const Frame& frame)
+{
+    m_submitted++;
+    if (m_mailbox.publish(frame)) {
+        m_dropped++;
+    }
+}
+
+void FrameOutput::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+    m_mailbox.interrupt();
+    m_thread.join();
+}
+
+OutputStats FrameOutput::getStats() const
+{
+    OutputStats stats;
+    stats.frames_submitted = m_submitted.load();
+    stats.frames_written = m_written.load();
+    stats.frames_dropped = m_dropped.load();
+    if (stats.frames_written > 0) {
+        stats.average_latency = nanoseconds(m_latency_total.load() / static_cast<int64_t>(stats.frames_written));
+    }
+    stats.worst_latency = nanoseconds(m_latency_worst.load());
+    return stats;
+}
+
+void FrameOutput::run()
+{
+    while (true)
+    {
+        // Read the sequence first so a frame published after take() still wakes us
+        const uint32_t seen = m_mailbox.sequence();
+        if (!m_running.load()) {
+            return;
+        }
+
+        FrameMailbox<Frame>::Clock::time_point published;
+        const Frame* frame = m_mailbox.take(&published);
+        if (!frame) {
+            m_mailbox.wait(seen);
+            continue;
+        }
+
+        const int64_t latency = duration_cast<nanoseconds>(FrameMailbox<Frame>::Clock::now() - published).count();
+        m_latency_total += latency;
+        if (latency > m_latency_worst.load()) {
+            m_latency_worst = latency;
+        }
+
+        m_sink(*frame);
+        m_written++;
+    }
+}
+
+} // namespace ht1632
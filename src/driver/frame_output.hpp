@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "frame_mailbox.hpp"
+#include "ht1632_protocol.hpp"
+
+namespace ht1632
+{
+
+struct OutputStats
+{
+    uint64_t frames_submitted = 0;
+    uint64_t frames_written = 0;
+    uint64_t frames_dropped = 0;                // replaced before the output thread took them
+    std::chrono::nanoseconds average_latency{0}; // submit until the output thread picked the frame up
+    std::chrono::nanoseconds worst_latency{0};
+};
+
+/**
+ * @brief Output stage that drives the panels from its own thread
+ *
+ * Rendering hands completed frames to submit(), which never waits for the
+ * bus. The output thread always writes the newest frame, frames submitted
+ * while a transfer is in progress are dropped except for the last one.
+ */
+class FrameOutput
+{
+public:
+    using Sink = std::function<void(const Frame&)>;
+
+    explicit FrameOutput(Sink sink);
+    ~FrameOutput();
+
+    FrameOutput(const FrameOutput&) = delete;
+    FrameOutput& operator=(const FrameOutput&) = delete;
+
+    // Only one thread may submit frames
+    void submit(const Frame& frame);
+
+    // Finishes the transfer in progress, frames still queued are not written
+    void stop();
+
+    OutputStats getStats() const;
+
+private:
+    void run();
+
+    Sink m_sink;
+    FrameMailbox<Frame> m_mailbox;
+    std::atomic<bool> m_running{true};
+
+    std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint64_t> m_written{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<int64_t> m_latency_total{0};
+    std::atomic<int64_t> m_latency_worst{0};
+
+    std::thread m_thread;
+};
+
+} // namespace ht1632
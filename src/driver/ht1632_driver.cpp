@@ -0,0 +1,247 @@
+#include <algorithm>
+
+#include "ht1632_driver.hpp"
+#include "log_util.hpp"
+
+namespace ht1632
+{
+
+// HT1632 requires minimum 1μs setup time, using 5μs for stability
+static constexpr uint16_t SELECT_SETUP_US = 5;
+static constexpr uint16_t WRITE_SETUP_US = 7;
+static constexpr uint16_t WRITE_HOLD_US = 2;
+static constexpr uint16_t INIT_COMMAND_DELAY_US = 50;
+
+Driver::Driver(Transport& transport, const display::Geometry& geometry, size_t chain)
+    : m_transport(transport),
+      m_panel_count(geometry.panelsIn(chain)),
+      m_width(geometry.width()),
+      m_extract(columnExtractor(geometry.panel_width, geometry.flip)),
+      m_first_column(m_panel_count),
+      m_sent(m_panel_count),
+      m_sent_valid(m_panel_count, false),
+      m_buffers(m_panel_count),
+      m_commands(m_panel_count)
+{
+    const size_t first_panel = geometry.firstPanelOf(chain);
+    for (size_t panel = 0; panel < m_panel_count; ++panel) {
+        m_first_column[panel] = geometry.firstColumnOf(first_panel + panel);
+    }
+}
+
+void Driver::sendCommand(int panel, uint8_t command, uint16_t delay_us)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    sendCommandLocked(panel, command, delay_us);
+}
+
+void Driver::sendCommandLocked(int panel, uint8_t command, uint16_t delay_us)
+{
+    if (isInEffect(panel, command))
+    {
+        m_commands_suppressed++;
+        return;
+    }
+
+    const auto buffer = createCommandBuffer(command);
+
+    m_transport.select(panel, SELECT_SETUP_US);
+    m_transport.write(buffer.data(), buffer.size(), delay_us);
+    m_transport.select(HT1632_PANEL_NONE, SELECT_SETUP_US);
+    m_commands_sent++;
+
+    auto apply = [command](CommandState& state) {
+        if ((command & 0xF0) == HT1632_CMD_PWM) {
+            state.pwm = command;
+        } else if (command == HT1632_CMD_LED_ON || command == HT1632_CMD_LED_OFF) {
+            state.leds = command;
+        } else if (command == HT1632_CMD_BLINK_ON || command == HT1632_CMD_BLINK_OFF) {
+            state.blink = command;
+        } else if (command == HT1632_CMD_SYS_DIS || command == HT1632_CMD_SYS_EN) {
+            // The LED duty cycle generator follows the oscillator
+            state.leds = -1;
+        }
+    };
+
+    if (panel == HT1632_PANEL_ALL) {
+        std::for_each(m_commands.begin(), m_commands.end(), apply);
+    } else if (panel >= 0 && static_cast<size_t>(panel) < m_panel_count) {
+        apply(m_commands[static_cast<size_t>(panel)]);
+    }
+}
+
+bool Driver::isInEffect(int panel, uint8_t command) const
+{
+    auto matches = [command](const CommandState& state) {
+        if ((command & 0xF0) == HT1632_CMD_PWM) {
+            return state.pwm == command;
+        }
+        if (command == HT1632_CMD_LED_ON || command == HT1632_CMD_LED_OFF) {
+            return state.leds == command;
+        }
+        if (command == HT1632_CMD_BLINK_ON || command == HT1632_CMD_BLINK_OFF) {
+            return state.blink == command;
+        }
+        return false;
+    };
+
+    if (panel == HT1632_PANEL_ALL) {
+        return std::all_of(m_commands.begin(), m_commands.end(), matches);
+    }
+    if (panel >= 0 && static_cast<size_t>(panel) < m_panel_count) {
+        return matches(m_commands[static_cast<size_t>(panel)]);
+    }
+    return false;
+}
+
+void Driver::initialize()
+{
+    {
+        // Whatever the panels were doing, nothing is known to be in effect
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::fill(m_commands.begin(), m_commands.end(), CommandState{});
+    }
+
+    sendCommand(HT1632_PANEL_ALL, HT1632_CMD_SYS_EN, INIT_COMMAND_DELAY_US);
+    sendCommand(HT1632_PANEL_ALL, HT1632_CMD_COM, INIT_COMMAND_DELAY_US);
+    sendCommand(HT1632_PANEL_ALL, HT1632_CMD_LED_ON, INIT_COMMAND_DELAY_US);
+    sendCommand(HT1632_PANEL_ALL, HT1632_CMD_BLINK_OFF, INIT_COMMAND_DELAY_US);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::fill(m_sent_valid.begin(), m_sent_valid.end(), false);
+}
+
+void Driver::writeFrame(const Frame& frame)
+{
+    if (frame.size() != m_width)
+    {
+        WARN_LOG("Dropping frame of " << frame.size() << " columns, the display has " << m_width);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool selected = false;
+    for (size_t panel = 0; panel < m_panel_count; ++panel)
+    {
+        PanelColumns columns;
+        m_extract(frame.data() + m_first_column[panel], columns);
+
+        // Only send the RAM range that changed, nothing if the panel is up to date
+        auto plan = planWrite(m_sent_valid[panel] ? &m_sent[panel] : nullptr, columns);
+        if (plan.nibbles == 0)
+        {
+            m_panels_skipped++;
+            m_bytes_skipped += WRITE_BUFFER_SIZE;
+            continue;
+        }
+
+        auto& buffer = m_buffers[panel];
+        auto size = createWriteBuffer(columns, plan, buffer);
+
+        m_transport.select(static_cast<int>(panel), WRITE_SETUP_US);
+        m_transport.write(buffer.data(), size, WRITE_HOLD_US);
+        selected = true;
+
+        m_sent[panel] = columns;
+        m_sent_valid[panel] = true;
+        m_panels_written++;
+        if (!plan.isFull())
+        {
+            m_panels_partial++;
+        }
+        m_bytes_written += size;
+        m_bytes_skipped += WRITE_BUFFER_SIZE - size;
+    }
+
+    if (selected) {
+        m_transport.select(HT1632_PANEL_NONE);
+    }
+}
+
+bool Driver::verifyNextPanel()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const size_t panel = m_verify_next;
+    m_verify_next = (m_verify_next + 1) % m_panel_count;
+
+    // Nothing to compare against until the panel has been written
+    if (!m_sent_valid[panel]) {
+        return true;
+    }
+
+    WriteBuffer request;
+    WriteBuffer response;
+    const size_t size = createReadBuffer(request);
+
+    m_transport.select(static_cast<int>(panel), WRITE_SETUP_US);
+    const bool supported = m_transport.read(request.data(), response.data(), size);
+    m_transport.select(HT1632_PANEL_NONE);
+
+    if (!supported || !isReadResponse(response)) {
+        return false;
+    }
+
+    m_panels_verified++;
+    if (decodeReadResponse(response) == m_sent[panel]) {
+        return true;
+    }
+
+    m_corruptions++;
+    WARN_LOG("Panel " << panel << " RAM does not match the last frame, reinitializing it");
+    repairPanel(panel);
+    return true;
+}
+
+void Driver::repairPanel(size_t panel)
+{
+    const int target = static_cast<int>(panel);
+    const int pwm = m_commands[panel].pwm;
+    m_commands[panel] = CommandState{};
+
+    sendCommandLocked(target, HT1632_CMD_SYS_EN, INIT_COMMAND_DELAY_US);
+    sendCommandLocked(target, HT1632_CMD_COM, INIT_COMMAND_DELAY_US);
+    sendCommandLocked(target, HT1632_CMD_LED_ON, INIT_COMMAND_DELAY_US);
+    sendCommandLocked(target, HT1632_CMD_BLINK_OFF, INIT_COMMAND_DELAY_US);
+    if (pwm >= 0) {
+        sendCommandLocked(target, static_cast<uint8_t>(pwm), INIT_COMMAND_DELAY_US);
+    }
+
+    WritePlan full;
+    full.nibbles = RAM_NIBBLES;
+    auto& buffer = m_buffers[panel];
+    const size_t size = createWriteBuffer(m_sent[panel], full, buffer);
+
+    m_transport.select(target, WRITE_SETUP_US);
+    m_transport.write(buffer.data(), size, WRITE_HOLD_US);
+    m_transport.select(HT1632_PANEL_NONE);
+
+    m_panels_written++;
+    m_bytes_written += size;
+    m_repairs++;
+}
+
+TransferStats Driver::getTransferStats() const
+{
+    TransferStats stats;
+    stats.panels_written = m_panels_written.load();
+    stats.panels_partial = m_panels_partial.load();
+    stats.panels_skipped = m_panels_skipped.load();
+    stats.bytes_written = m_bytes_written.load();
+    stats.bytes_skipped = m_bytes_skipped.load();
+    stats.commands_sent = m_commands_sent.load();
+    stats.commands_suppressed = m_commands_suppressed.load();
+    return stats;
+}
+
+HealthStats Driver::getHealthStats() const
+{
+    HealthStats stats;
+    stats.panels_verified = m_panels_verified.load();
+    stats.corruptions_detected = m_corruptions.load();
+    stats.panels_repaired = m_repairs.load();
+    return stats;
+}
+
+} // namespace ht1632
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "geometry.hpp"
+#include "ht1632_protocol.hpp"
+#include "transport.hpp"
+
+namespace ht1632
+{
+
+/* SPI traffic counters, unchanged panels are skipped and small changes sent as partial writes */
+struct TransferStats
+{
+    uint64_t panels_written = 0;
+    uint64_t panels_partial = 0;
+    uint64_t panels_skipped = 0;
+    uint64_t bytes_written = 0;
+    uint64_t bytes_skipped = 0;
+    uint64_t commands_sent = 0;
+    uint64_t commands_suppressed = 0;
+};
+
+/* Readback verification counters */
+struct HealthStats
+{
+    uint64_t panels_verified = 0;
+    uint64_t corruptions_detected = 0;
+    uint64_t panels_repaired = 0;
+};
+
+/**
+ * @brief HT1632 protocol on top of a Transport
+ *
+ * Remembers what each panel's RAM holds so a frame only sends the range of
+ * columns that changed, and which PWM, LED and blink commands are in effect
+ * so repeating one sends nothing. Commands and frames may come from
+ * different threads, transfers are serialized.
+ */
+class Driver
+{
+public:
+    /**
+     * @param geometry Valid panel layout, panels are addressed in chain order
+     * @param chain Chain of the geometry the transport reaches, its panels are numbered from 0
+     */
+    Driver(Transport& transport, const display::Geometry& geometry, size_t chain = 0);
+
+    /**
+     * @brief Send a command, unless it is a PWM, LED or blink command already in effect on the panels
+     *
+     * @param panel Panel index or HT1632_PANEL_ALL
+     * @param delay_us Delay after the command, before deselecting
+     */
+    void sendCommand(int panel, uint8_t command, uint16_t delay_us = 2);
+
+    // Enable the oscillators and LEDs, RAM contents and PWM are unknown afterwards
+    void initialize();
+
+    // Frames must be geometry.width() columns wide, only this chain's columns are sent
+    void writeFrame(const Frame& frame);
+
+    /**
+     * @brief Read back the next panel's RAM, round robin, and compare it with what was written
+     *
+     * A panel that differs is reinitialized and rewritten on its own, the
+     * others are left alone.
+     *
+     * @return false if the transport cannot read or nothing answered on MISO
+     */
+    bool verifyNextPanel();
+
+    TransferStats getTransferStats() const;
+    HealthStats getHealthStats() const;
+
+private:
+    // Commands whose effect is tracked, -1 while unknown
+    struct CommandState
+    {
+        int pwm = -1;
+        int leds = -1;
+        int blink = -1;
+    };
+
+    void sendCommandLocked(int panel, uint8_t command, uint16_t delay_us);
+    bool isInEffect(int panel, uint8_t command) const;
+    void repairPanel(size_t panel);
+
+    Transport& m_transport;
+    const size_t m_panel_count;
+    const size_t m_width;
+    const ColumnExtractor m_extract;
+    std::vector<size_t> m_first_column;     // per panel, where its columns start in a frame
+    std::mutex m_mutex;
+
+    // Column data last transmitted to each panel, invalid until first written
+    std::vector<PanelColumns> m_sent;
+    std::vector<bool> m_sent_valid;
+
+    // Kept until the frame's final deselect, transports may still point into them
+    std::vector<WriteBuffer> m_buffers;
+
+    // Last commands applied to each panel, the PWM level is restored after a repair
+    std::vector<CommandState> m_commands;
+    size_t m_verify_next = 0;
+
+    std::atomic<uint64_t> m_panels_written{0};
+    std::atomic<uint64_t> m_panels_partial{0};
+    std::atomic<uint64_t> m_panels_skipped{0};
+    std::atomic<uint64_t> m_bytes_written{0};
+    std::atomic<uint64_t> m_bytes_skipped{0};
+    std::atomic<uint64_t> m_commands_sent{0};
+    std::atomic<uint64_t> m_commands_suppressed{0};
+
+    std::atomic<uint64_t> m_panels_verified{0};
+    std::atomic<uint64_t> m_corruptions{0};
+    std::atomic<uint64_t> m_repairs{0};
+};
+
+} // namespace ht1632
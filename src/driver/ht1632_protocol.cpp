@@ -0,0 +1,177 @@
+#include "ht1632_protocol.hpp"
+
+namespace ht1632
+{
+
+// Nibbles in wire order, even addresses hold the upper half of a column
+static uint8_t nibbleAt(const PanelColumns& columns, size_t address)
+{
+    address %= RAM_NIBBLES;
+    const uint8_t column = columns[address / 2];
+    return static_cast<uint8_t>((address % 2 == 0 ? column >> 4 : column) & 0x0F);
+}
+
+// Shifts whole fields into a 64-bit accumulator and stores complete bytes
+class BitWriter
+{
+public:
+    explicit BitWriter(WriteBuffer& buffer) : m_buffer(buffer) {}
+
+    void put(uint32_t value, size_t count)
+    {
+        m_bits = (m_bits << count) | (value & ((1U << count) - 1U));
+        m_count += count;
+        while (m_count >= 8) {
+            m_count -= 8;
+            m_buffer[m_pos++] = static_cast<uint8_t>(m_bits >> m_count);
+        }
+    }
+
+private:
+    WriteBuffer& m_buffer;
+    uint64_t m_bits = 0;
+    size_t m_count = 0;
+    size_t m_pos = 0;
+};
+
+template <bool Flip>
+static ColumnExtractor columnExtractorFor(size_t panel_width)
+{
+    switch (panel_width) {
+        case 8: return &extractPanelColumns<8, Flip>;
+        case 16: return &extractPanelColumns<16, Flip>;
+        case 24: return &extractPanelColumns<24, Flip>;
+        case 32: return &extractPanelColumns<32, Flip>;
+        default: return nullptr;
+    }
+}
+
+ColumnExtractor columnExtractor(size_t panel_width, bool flip)
+{
+    return flip ? columnExtractorFor<true>(panel_width) : columnExtractorFor<false>(panel_width);
+}
+
+WritePlan planWrite(const PanelColumns* previous, const PanelColumns& next)
+{
+    WritePlan full;
+    full.address = 0;
+    full.nibbles = RAM_NIBBLES;
+
+    if (!previous) {
+        return full;
+    }
+
+    // The smallest circular range covering all changes is everything
+    // except the largest run of unchanged nibbles between two changes
+    size_t first = RAM_NIBBLES;
+    size_t last = 0;
+    size_t best_gap = 0;
+    size_t start = 0;
+    for (size_t address = 0; address < RAM_NIBBLES; ++address) {
+        if (nibbleAt(*previous, address) == nibbleAt(next, address)) {
+            continue;
+        }
+        if (first == RAM_NIBBLES) {
+            first = address;
+        } else if (address - last - 1 > best_gap) {
+            best_gap = address - last - 1;
+            start = address;
+        }
+        last = address;
+    }
+
+    if (first == RAM_NIBBLES) {
+        return WritePlan();
+    }
+
+    // The gap wrapping past the end of RAM
+    if (first + RAM_NIBBLES - last - 1 >= best_gap) {
+        best_gap = first + RAM_NIBBLES - last - 1;
+        start = first;
+    }
+
+    const size_t nibbles = RAM_NIBBLES - best_gap;
+    if (writeSize(nibbles) >= writeSize(RAM_NIBBLES)) {
+        return full;
+    }
+
+    WritePlan plan;
+    plan.address = static_cast<uint8_t>(start);
+    plan.nibbles = static_cast<uint8_t>(nibbles);
+    return plan;
+}
+
+size_t createWriteBuffer(const PanelColumns& columns, const WritePlan& plan, WriteBuffer& buffer)
+{
+    if (plan.nibbles == 0) {
+        return 0;
+    }
+
+    const size_t size = writeSize(plan.nibbles);
+    BitWriter writer(buffer);
+
+    // Header: write command (3 bits) + start address (7 bits)
+    writer.put(HT1632_ID_WRITE, HT1632_LENGTH_ID);
+    writer.put(plan.address, HT1632_LENGTH_ADDR);
+
+    // Data runs past the planned range up to a whole byte, wrapping like
+    // the chip does, so trailing bits rewrite what RAM already holds
+    size_t remaining = size * 8 - HT1632_LENGTH_ID - HT1632_LENGTH_ADDR;
+    size_t address = plan.address;
+
+    if (address % 2 != 0) {
+        writer.put(nibbleAt(columns, address++), 4);
+        remaining -= 4;
+    }
+
+    for (; remaining >= 8; remaining -= 8, address += 2) {
+        writer.put(columns[(address % RAM_NIBBLES) / 2], 8);
+    }
+
+    if (remaining > 0) {
+        writer.put(static_cast<uint32_t>(columns[(address % RAM_NIBBLES) / 2] >> (8 - remaining)), remaining);
+    }
+
+    return size;
+}
+
+size_t createReadBuffer(WriteBuffer& buffer)
+{
+    buffer.fill(0);
+
+    BitWriter writer(buffer);
+    writer.put(HT1632_ID_READ, HT1632_LENGTH_ID);
+    writer.put(0, HT1632_LENGTH_ADDR);
+
+    return writeSize(RAM_NIBBLES);
+}
+
+PanelColumns decodeReadResponse(const WriteBuffer& response)
+{
+    // Data starts right after the 10 header bits, two bits into the second byte
+    constexpr size_t shift = HT1632_LENGTH_ID + HT1632_LENGTH_ADDR - 8;
+
+    PanelColumns columns;
+    for (size_t col = 0; col < columns.size(); ++col) {
+        const auto word = static_cast<uint16_t>((response[col + 1] << 8) | response[col + 2]);
+        columns[col] = static_cast<uint8_t>(word >> (8 - shift));
+    }
+    return columns;
+}
+
+bool isReadResponse(const WriteBuffer& response)
+{
+    return (response[0] >> (8 - HT1632_LENGTH_ID)) == HT1632_ID_READ;
+}
+
+CommandBuffer createCommandBuffer(uint8_t command)
+{
+    const auto data = static_cast<uint16_t>(((HT1632_ID_CMD << 8) | command) << 1);
+
+    CommandBuffer buffer;
+    buffer[0] = static_cast<uint8_t>((data >> 4) & 0xFF);   // Upper 8 bits
+    buffer[1] = static_cast<uint8_t>((data << 4) & 0xF0);   // Lower 4 bits, left-aligned
+    return buffer;
+}
+
+} // namespace ht1632
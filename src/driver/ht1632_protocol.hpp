@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "geometry.hpp"
+#include "ht1632.hpp"
+
+namespace ht1632
+{
+
+// Whole display, one byte per column with the top row in bit 0
+using Frame = display::Framebuffer;
+
+// Columns of RAM in each chip, narrower panels only show the first ones
+constexpr size_t RAM_COLUMNS = 32;
+
+// Column data for one panel in wire order: bit 7 is the top row, which is
+// clocked out first, so a column is shifted into the stream unchanged
+using PanelColumns = std::array<uint8_t, RAM_COLUMNS>;
+
+// Each 4-bit RAM address holds half a column
+constexpr size_t RAM_NIBBLES = RAM_COLUMNS * 2;
+
+// Full write: 10 header bits + 256 data bits + 6 padding bits
+constexpr size_t WRITE_BUFFER_SIZE = 34;
+using WriteBuffer = std::array<unsigned char, WRITE_BUFFER_SIZE>;
+
+constexpr std::array<uint8_t, 256> makeReverseTable()
+{
+    std::array<uint8_t, 256> table{};
+    for (size_t value = 0; value < table.size(); ++value) {
+        uint8_t reversed = 0;
+        for (size_t bit = 0; bit < 8; ++bit) {
+            if (value & (1U << bit)) {
+                reversed = static_cast<uint8_t>(reversed | (0x80U >> bit));
+            }
+        }
+        table[value] = reversed;
+    }
+    return table;
+}
+
+// Bit order reversal of every byte value
+inline constexpr std::array<uint8_t, 256> REVERSE_BITS = makeReverseTable();
+
+/**
+ * @brief Extract one panel's columns in wire order
+ *
+ * Display buffer columns have the top row in bit 0. When Flip is set the
+ * display is mounted upside down: columns are taken in reverse order and the
+ * rows flipped, which cancels out the wire order reversal. RAM columns past
+ * Width are cleared.
+ *
+ * @param source First of the Width framebuffer columns the panel shows
+ */
+template <size_t Width, bool Flip>
+void extractPanelColumns(const uint8_t* source, PanelColumns& columns)
+{
+    static_assert(Width <= RAM_COLUMNS);
+
+    if constexpr (Flip) {
+        for (size_t col = 0; col < Width; ++col) {
+            columns[col] = source[Width - 1 - col];
+        }
+    } else {
+        for (size_t col = 0; col < Width; ++col) {
+            columns[col] = REVERSE_BITS[source[col]];
+        }
+    }
+    if constexpr (Width < RAM_COLUMNS) {
+        std::fill(columns.begin() + Width, columns.end(), uint8_t{0});
+    }
+}
+
+using ColumnExtractor = void (*)(const uint8_t* source, PanelColumns& columns);
+
+/**
+ * @brief extractPanelColumns() specialized for a panel width
+ * @return nullptr if the width is not one of display::SUPPORTED_PANEL_WIDTHS
+ */
+ColumnExtractor columnExtractor(size_t panel_width, bool flip);
+
+/**
+ * @brief Successive write of a contiguous (wrapping) range of RAM nibbles
+ */
+struct WritePlan
+{
+    uint8_t address = 0;    // first RAM address written
+    uint8_t nibbles = 0;    // number of addresses written, 0 = nothing to send
+
+    bool isFull() const { return nibbles == RAM_NIBBLES; }
+};
+
+/**
+ * @brief Plan the cheapest write that turns panel RAM from previous into next
+ * @param previous Columns known to be in panel RAM, nullptr if unknown
+ * @param next Columns to show
+ * @return Smallest circular nibble range covering every change, or a full
+ *         write from address 0 when that costs no more bytes
+ */
+WritePlan planWrite(const PanelColumns* previous, const PanelColumns& next);
+
+/**
+ * @brief Number of SPI bytes needed for a write of the given nibble count
+ */
+constexpr size_t writeSize(size_t nibbles)
+{
+    return (HT1632_LENGTH_ID + HT1632_LENGTH_ADDR + nibbles * 4 + 7) / 8;
+}
+
+/**
+ * @brief Encode a planned write into buffer
+ *
+ * Trailing bits needed to fill the last byte repeat the nibbles that follow
+ * the range, so the chip's address auto-increment rewrites them unchanged.
+ *
+ * @return Number of bytes to transmit
+ */
+size_t createWriteBuffer(const PanelColumns& columns, const WritePlan& plan, WriteBuffer& buffer);
+
+/**
+ * @brief Encode a read of the whole panel RAM from address 0
+ *
+ * Only the header is set, the panel drives the data line for the remaining
+ * bits of a full-duplex transfer of the returned size.
+ */
+size_t createReadBuffer(WriteBuffer& buffer);
+
+// Panel RAM from the response to a createReadBuffer() transfer
+PanelColumns decodeReadResponse(const WriteBuffer& response);
+
+/**
+ * @brief Whether a panel answered a createReadBuffer() transfer
+ *
+ * MISO sees the shared data line, so the response starts with the read ID
+ * the host drove onto it. A line nothing drives reads all 0x00 or all 0xFF
+ * and cannot reproduce it, while a blank panel still can.
+ */
+bool isReadResponse(const WriteBuffer& response);
+
+// Command mode: 3-bit ID, 8-bit command and one don't-care bit, padded to 2 bytes
+using CommandBuffer = std::array<unsigned char, 2>;
+
+CommandBuffer createCommandBuffer(uint8_t command);
+
+} // namespace ht1632
@@ -0,0 +1,155 @@
+#include <algorithm>
+
+#include "loopback_transport.hpp"
+
+namespace ht1632
+{
+
+PanelColumns PanelState::columns() const
+{
+    PanelColumns columns;
+    for (size_t col = 0; col < columns.size(); ++col) {
+        columns[col] = static_cast<uint8_t>((ram[col * 2] << 4) | ram[col * 2 + 1]);
+    }
+    return columns;
+}
+
+LoopbackTransport::LoopbackTransport(size_t panel_count)
+    : m_panels(panel_count)
+{
+}
+
+void LoopbackTransport::select(int panel, uint16_t)
+{
+    if (m_selected == HT1632_PANEL_ALL) {
+        for (auto& state : m_panels) {
+            decode(state, m_selected_from, m_bits.size());
+        }
+    } else if (m_selected >= 0 && static_cast<size_t>(m_selected) < m_panels.size()) {
+        decode(m_panels[static_cast<size_t>(m_selected)], m_selected_from, m_bits.size());
+    }
+
+    m_selected = panel;
+    m_selected_from = m_bits.size();
+    m_selects++;
+}
+
+void LoopbackTransport::write(const void* data, size_t size, uint16_t)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t bit = 8; bit-- > 0;) {
+            m_bits.push_back((bytes[i] >> bit) & 1U);
+        }
+    }
+    m_bytes_sent += size;
+}
+
+bool LoopbackTransport::read(const void* data, void* response, size_t size)
+{
+    const size_t header = m_bits.size();
+    write(data, size);
+
+    auto* out = static_cast<uint8_t*>(response);
+    std::fill(out, out + size, uint8_t{0});
+
+    // The host drives the header, MISO sees it go out on the shared data line
+    for (size_t bit = 0; bit < HT1632_LENGTH_ID + HT1632_LENGTH_ADDR && bit < size * 8; ++bit) {
+        if (m_bits[header + bit]) {
+            out[bit / 8] = static_cast<uint8_t>(out[bit / 8] | (0x80U >> (bit % 8)));
+        }
+    }
+
+    if (m_selected < 0 || static_cast<size_t>(m_selected) >= m_panels.size()) {
+        return true;
+    }
+
+    // Read mode: after the ID and address the panel shifts out RAM data, 4 bits per address
+    auto bitAt = [&](size_t i) { return m_bits[header + i]; };
+    uint32_t id = 0;
+    size_t address = 0;
+    for (size_t i = 0; i < HT1632_LENGTH_ID; ++i) {
+        id = (id << 1) | (bitAt(i) ? 1U : 0U);
+    }
+    for (size_t i = 0; i < HT1632_LENGTH_ADDR; ++i) {
+        address = (address << 1) | (bitAt(HT1632_LENGTH_ID + i) ? 1U : 0U);
+    }
+    if (id != HT1632_ID_READ) {
+        return true;
+    }
+
+    const auto& ram = m_panels[static_cast<size_t>(m_selected)].ram;
+    for (size_t bit = HT1632_LENGTH_ID + HT1632_LENGTH_ADDR, i = 0; bit < size * 8; ++bit, ++i) {
+        const uint8_t nibble = ram[(address + i / 4) % RAM_NIBBLES];
+        if ((nibble >> (3 - i % 4)) & 1U) {
+            out[bit / 8] = static_cast<uint8_t>(out[bit / 8] | (0x80U >> (bit % 8)));
+        }
+    }
+    return true;
+}
+
+void LoopbackTransport::clear()
+{
+    // Bits of a selection still open are kept so it decodes correctly
+    m_bits.erase(m_bits.begin(), m_bits.begin() + static_cast<std::ptrdiff_t>(m_selected_from));
+    m_selected_from = 0;
+}
+
+void LoopbackTransport::decode(PanelState& panel, size_t begin, size_t end) const
+{
+    auto read = [&](size_t count) {
+        uint32_t value = 0;
+        for (size_t i = 0; i < count; ++i) {
+            value = (value << 1) | (m_bits[begin++] ? 1U : 0U);
+        }
+        return value;
+    };
+
+    if (end - begin < HT1632_LENGTH_ID) {
+        return;
+    }
+
+    const uint32_t id = read(HT1632_LENGTH_ID);
+
+    if (id == HT1632_ID_CMD) {
+        // Successive commands, each followed by one don't-care bit
+        while (end - begin >= HT1632_LENGTH_CMD + 1) {
+            const auto command = static_cast<uint8_t>(read(HT1632_LENGTH_CMD));
+            read(1);
+            panel.commands++;
+
+            if (command == HT1632_CMD_SYS_DIS) {
+                panel.system_enabled = false;
+            } else if (command == HT1632_CMD_SYS_EN) {
+                panel.system_enabled = true;
+            } else if (command == HT1632_CMD_LED_OFF) {
+                panel.leds_on = false;
+            } else if (command == HT1632_CMD_LED_ON) {
+                panel.leds_on = true;
+            } else if (command == HT1632_CMD_BLINK_OFF) {
+                panel.blinking = false;
+            } else if (command == HT1632_CMD_BLINK_ON) {
+                panel.blinking = true;
+            } else if ((command & 0xF0) == HT1632_CMD_PWM) {
+                panel.pwm = command & 0x0F;
+            } else if ((command & 0xF0) == HT1632_CMD_COM) {
+                panel.com = command;
+            }
+        }
+    } else if (id == HT1632_ID_WRITE && end - begin >= HT1632_LENGTH_ADDR) {
+        // Successive write, every bit lands in RAM as it is clocked in
+        size_t address = read(HT1632_LENGTH_ADDR);
+        panel.writes++;
+
+        while (begin < end) {
+            auto& nibble = panel.ram[address % RAM_NIBBLES];
+            for (uint32_t bit = 4; bit-- > 0 && begin < end;) {
+                const auto mask = static_cast<uint8_t>(1U << bit);
+                nibble = static_cast<uint8_t>(read(1) ? nibble | mask : nibble & ~mask);
+            }
+            address++;
+        }
+    }
+}
+
+} // namespace ht1632
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ht1632_protocol.hpp"
+#include "transport.hpp"
+
+namespace ht1632
+{
+
+/**
+ * @brief State of one panel as rebuilt from the bits it received
+ */
+struct PanelState
+{
+    // One nibble per RAM address, the first bit clocked in is bit 3
+    std::array<uint8_t, RAM_NIBBLES> ram{};
+
+    bool system_enabled = false;
+    bool leds_on = false;
+    bool blinking = false;
+    uint8_t pwm = 0;
+    uint8_t com = 0;            // last COM option command, 0 if never set
+
+    uint64_t commands = 0;
+    uint64_t writes = 0;
+
+    // RAM contents as columns in wire order, comparable with PanelColumns
+    PanelColumns columns() const;
+};
+
+/**
+ * @brief In-memory transport that records every bit and decodes it into panel state
+ *
+ * Bits sent while panels are selected are decoded when the selection
+ * changes, the way the chips act on them when chip select is released.
+ */
+class LoopbackTransport : public Transport
+{
+public:
+    explicit LoopbackTransport(size_t panel_count);
+
+    void select(int panel, uint16_t setup_delay_us = 0) override;
+    void write(const void* data, size_t size, uint16_t delay_us = 0) override;
+
+    // Answers reads from the selected panel's RAM, after echoing the header
+    bool read(const void* data, void* response, size_t size) override;
+
+    const PanelState& panel(size_t index) const { return m_panels[index]; }
+
+    // Direct access, e.g. to simulate a panel losing its RAM contents
+    PanelState& panel(size_t index) { return m_panels[index]; }
+
+    // Every bit sent since construction or the last clear()
+    const std::vector<bool>& bits() const { return m_bits; }
+    uint64_t getBytesSent() const { return m_bytes_sent; }
+    uint64_t getSelectCount() const { return m_selects; }
+
+    void clear();
+
+private:
+    void decode(PanelState& panel, size_t begin, size_t end) const;
+
+    std::vector<PanelState> m_panels;
+    std::vector<bool> m_bits;
+    int m_selected = HT1632_PANEL_NONE;
+    size_t m_selected_from = 0;     // first bit sent to the current selection
+    uint64_t m_bytes_sent = 0;
+    uint64_t m_selects = 0;
+};
+
+} // namespace ht1632
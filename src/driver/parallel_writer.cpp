@@ -0,0 +1,82 @@
+#include "parallel_writer.hpp"
+
+using namespace std::chrono;
+
+namespace ht1632
+{
+
+ParallelWriter::ParallelWriter(std::vector<Chain> chains)
+    : m_chains(std::move(chains)),
+      m_start(static_cast<std::ptrdiff_t>(m_chains.size())),
+      m_done(static_cast<std::ptrdiff_t>(m_chains.size()))
+{
+    for (size_t chain = 1; chain < m_chains.size(); ++chain) {
+        m_workers.emplace_back([this, chain] { run(chain); });
+    }
+}
+
+ParallelWriter::~ParallelWriter()
+{
+    if (m_workers.empty()) {
+        return;
+    }
+
+    // Workers only wait at the start barrier between frames
+    m_stopping = true;
+    m_start.arrive_and_wait();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ParallelWriter::write(const Frame& frame)
+{
+    const auto started = steady_clock::now();
+
+    m_frame = &frame;
+    if (!m_workers.empty()) {
+        m_start.arrive_and_wait();
+    }
+
+    m_chains[0](frame);
+
+    // Commit: nothing moves on to the next frame until every chain has this one
+    if (!m_workers.empty()) {
+        m_done.arrive_and_wait();
+    }
+    m_frame = nullptr;
+
+    const int64_t elapsed = duration_cast<nanoseconds>(steady_clock::now() - started).count();
+    m_frames++;
+    m_frame_total += elapsed;
+    if (elapsed > m_frame_worst.load()) {
+        m_frame_worst = elapsed;
+    }
+}
+
+ChainStats ParallelWriter::getStats() const
+{
+    ChainStats stats;
+    stats.frames = m_frames.load();
+    if (stats.frames > 0) {
+        stats.average_frame = nanoseconds(m_frame_total.load() / static_cast<int64_t>(stats.frames));
+    }
+    stats.worst_frame = nanoseconds(m_frame_worst.load());
+    return stats;
+}
+
+void ParallelWriter::run(size_t chain)
+{
+    while (true)
+    {
+        m_start.arrive_and_wait();
+        if (m_stopping) {
+            return;
+        }
+
+        m_chains[chain](*m_frame);
+        m_done.arrive_and_wait();
+    }
+}
+
+} // namespace ht1632
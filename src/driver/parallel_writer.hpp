@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "ht1632_protocol.hpp"
+
+namespace ht1632
+{
+
+struct ChainStats
+{
+    uint64_t frames = 0;
+    std::chrono::nanoseconds average_frame{0};  // until the slowest chain finished
+    std::chrono::nanoseconds worst_frame{0};
+};
+
+/**
+ * @brief Writes each frame to several independent chains at once
+ *
+ * Every chain has a worker thread, except the first which runs on the
+ * caller. write() releases all of them on the same frame and returns once
+ * the last one is done, so chains never show different frames for longer
+ * than one transfer and the frame time is that of the slowest chain rather
+ * than the sum of all of them.
+ */
+class ParallelWriter
+{
+public:
+    using Chain = std::function<void(const Frame&)>;
+
+    explicit ParallelWriter(std::vector<Chain> chains);
+    ~ParallelWriter();
+
+    ParallelWriter(const ParallelWriter&) = delete;
+    ParallelWriter& operator=(const ParallelWriter&) = delete;
+
+    // Only one thread may write, frame must stay valid until this returns
+    void write(const Frame& frame);
+
+    ChainStats getStats() const;
+
+private:
+    void run(size_t chain);
+
+    std::vector<Chain> m_chains;
+    std::barrier<> m_start;
+    std::barrier<> m_done;
+    const Frame* m_frame = nullptr;     // published to the workers by m_start
+    bool m_stopping = false;
+
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<int64_t> m_frame_total{0};
+    std::atomic<int64_t> m_frame_worst{0};
+
+    std::vector<std::thread> m_workers;
+};
+
+} // namespace ht1632
@@ -0,0 +1,154 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <linux/gpio.h>
+
+#include "ht1632.hpp"
+#include "spidev_transport.hpp"
+
+namespace ht1632
+{
+
+SpidevTransport::SpidevTransport(int spi_fd, int cs_fd, size_t cs_count, uint32_t speed_hz, Ioctl ioctl)
+    : m_spi_fd(spi_fd),
+      m_cs_fd(cs_fd),
+      m_cs_count(cs_count),
+      m_speed_hz(speed_hz),
+      m_ioctl(std::move(ioctl))
+{
+}
+
+SpidevTransport::~SpidevTransport()
+{
+    close(m_cs_fd);
+    close(m_spi_fd);
+}
+
+std::unique_ptr<SpidevTransport> SpidevTransport::open(const char* spi_device, const char* gpio_chip,
+                                           const std::vector<uint32_t>& cs_lines, uint32_t speed_hz)
+{
+    if (cs_lines.empty() || cs_lines.size() > GPIO_V2_LINES_MAX) {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    int spi_fd = ::open(spi_device, O_RDWR | O_CLOEXEC);
+    if (spi_fd < 0) {
+        return nullptr;
+    }
+
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if (ioctl(spi_fd, SPI_IOC_WR_MODE, &mode) < 0 ||
+        ioctl(spi_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+        ioctl(spi_fd, SPI_IOC_WR_MAX_SPEED_HZ, &speed_hz) < 0) {
+        close(spi_fd);
+        return nullptr;
+    }
+
+    int chip_fd = ::open(gpio_chip, O_RDWR | O_CLOEXEC);
+    if (chip_fd < 0) {
+        close(spi_fd);
+        return nullptr;
+    }
+
+    // Request every chip select as an output, all deselected (high)
+    gpio_v2_line_request request{};
+    for (size_t i = 0; i < cs_lines.size(); ++i) {
+        request.offsets[i] = cs_lines[i];
+    }
+    strncpy(request.consumer, "ht1632", sizeof(request.consumer) - 1);
+    request.num_lines = static_cast<uint32_t>(cs_lines.size());
+    request.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+    request.config.num_attrs = 1;
+    request.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    request.config.attrs[0].attr.values = (uint64_t{1} << cs_lines.size()) - 1;
+    request.config.attrs[0].mask = request.config.attrs[0].attr.values;
+
+    int result = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &request);
+    close(chip_fd);
+    if (result < 0) {
+        close(spi_fd);
+        return nullptr;
+    }
+
+    return std::make_unique<SpidevTransport>(spi_fd, request.fd, cs_lines.size(), speed_hz);
+}
+
+void SpidevTransport::select(int panel, uint16_t setup_delay_us)
+{
+    flush();
+
+    const uint64_t all = (uint64_t{1} << m_cs_count) - 1;
+
+    gpio_v2_line_values values{};
+    values.mask = all;
+    if (panel == HT1632_PANEL_ALL) {
+        values.bits = 0;
+    } else if (panel >= 0 && static_cast<size_t>(panel) < m_cs_count) {
+        values.bits = all & ~(uint64_t{1} << panel);
+    } else {
+        values.bits = all;
+    }
+
+    if (call(m_cs_fd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0) {
+        perror("Chip select failed");
+        exit(EXIT_FAILURE);
+    }
+
+    // Nothing follows a deselect, a delay would only cost another syscall
+    if (setup_delay_us > 0 && panel != HT1632_PANEL_NONE) {
+        write(nullptr, 0, setup_delay_us);
+    }
+}
+
+void SpidevTransport::write(const void* data, size_t size, uint16_t delay_us)
+{
+    if (m_queued == m_batch.size()) {
+        flush();
+    }
+
+    spi_ioc_transfer& transfer = m_batch[m_queued++];
+    transfer = spi_ioc_transfer{};
+    transfer.tx_buf = reinterpret_cast<uintptr_t>(data);
+    transfer.len = static_cast<uint32_t>(size);
+    transfer.speed_hz = m_speed_hz;
+    transfer.delay_usecs = delay_us;
+    transfer.bits_per_word = 8;
+}
+
+bool SpidevTransport::read(const void* data, void* response, size_t size)
+{
+    write(data, size);
+    m_batch[m_queued - 1].rx_buf = reinterpret_cast<uintptr_t>(response);
+    flush();
+    return true;
+}
+
+void SpidevTransport::flush()
+{
+    if (m_queued == 0) {
+        return;
+    }
+
+    const auto count = static_cast<unsigned>(m_queued);
+    m_queued = 0;
+
+    if (call(m_spi_fd, SPI_IOC_MESSAGE(count), m_batch.data()) < 0) {
+        perror("SPI write failed");
+        exit(EXIT_FAILURE);
+    }
+}
+
+int SpidevTransport::call(int fd, unsigned long request, void* arg)
+{
+    m_syscalls++;
+    return m_ioctl ? m_ioctl(fd, request, arg) : ioctl(fd, request, arg);
+}
+
+} // namespace ht1632
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <linux/spi/spidev.h>
+
+#include "transport.hpp"
+
+namespace ht1632
+{
+
+/**
+ * @brief Transport driven through spidev, with chip selects on GPIO character device lines
+ *
+ * Transfers are queued and submitted together as one SPI_IOC_MESSAGE batch,
+ * their delays run in the kernel between transfers instead of busy waiting.
+ * The chip select lines are not part of the SPI controller, so the batch is
+ * flushed whenever the selection changes.
+ */
+class SpidevTransport : public Transport
+{
+public:
+    // Syscall hook so tests can stand in for the spidev and GPIO devices
+    using Ioctl = std::function<int(int fd, unsigned long request, void* arg)>;
+
+    // Transfers per batch before write() flushes on its own
+    static constexpr size_t MAX_BATCH = 16;
+
+    /**
+     * @param spi_fd Open spidev device
+     * @param cs_fd GPIO line request holding one output line per panel, in panel order
+     * @param cs_count Number of chip select lines in the request
+     * Both descriptors are owned and closed by the bus.
+     */
+    SpidevTransport(int spi_fd, int cs_fd, size_t cs_count, uint32_t speed_hz, Ioctl ioctl = nullptr);
+    ~SpidevTransport() override;
+
+    SpidevTransport(const SpidevTransport&) = delete;
+    SpidevTransport& operator=(const SpidevTransport&) = delete;
+
+    /**
+     * @brief Open the spidev device and request the chip select lines
+     * @return nullptr on failure, with errno describing the error
+     */
+    static std::unique_ptr<SpidevTransport> open(const char* spi_device, const char* gpio_chip,
+                                           const std::vector<uint32_t>& cs_lines, uint32_t speed_hz);
+
+    /**
+     * @brief Flush queued transfers and drive the chip selects (active low)
+     * @param panel Panel index, HT1632_PANEL_ALL or HT1632_PANEL_NONE
+     * @param setup_delay_us Delay before the first transfer to the new selection
+     */
+    void select(int panel, uint16_t setup_delay_us = 0) override;
+
+    /**
+     * @brief Queue a write-only transfer followed by a delay
+     *
+     * data must stay valid until the batch is flushed by select() or flush().
+     */
+    void write(const void* data, size_t size, uint16_t delay_us = 0) override;
+
+    // Flushes the batch, the response is complete on return
+    bool read(const void* data, void* response, size_t size) override;
+
+    // Submit queued transfers in one syscall
+    void flush();
+
+    uint64_t getSyscallCount() const { return m_syscalls; }
+
+private:
+    int call(int fd, unsigned long request, void* arg);
+
+    int m_spi_fd;
+    int m_cs_fd;
+    size_t m_cs_count;
+    uint32_t m_speed_hz;
+    Ioctl m_ioctl;
+
+    std::array<spi_ioc_transfer, MAX_BATCH> m_batch{};
+    size_t m_queued = 0;
+    uint64_t m_syscalls = 0;
+};
+
+} // namespace ht1632
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ht1632
+{
+
+/**
+ * @brief Physical link to the HT1632 panels
+ *
+ * Commands and RAM writes are both plain bit streams sent while the target
+ * panels are selected, the protocol on top is handled by ht1632::Driver.
+ * Implementations may buffer writes until the selection changes, so data
+ * passed to write() must stay valid until the next select().
+ */
+class Transport
+{
+public:
+    virtual ~Transport() = default;
+
+    /**
+     * @brief Drive the chip selects
+     * @param panel Panel index, HT1632_PANEL_ALL or HT1632_PANEL_NONE
+     * @param setup_delay_us Delay before the first write to the new selection
+     */
+    virtual void select(int panel, uint16_t setup_delay_us = 0) = 0;
+
+    /**
+     * @brief Send size bytes MSB first, then wait delay_us
+     */
+    virtual void write(const void* data, size_t size, uint16_t delay_us = 0) = 0;
+
+    /**
+     * @brief Full-duplex transfer of size bytes, storing what the selected panel sent back
+     *
+     * Needs the panels' data line readable by the host and RD wired, which
+     * the reference hardware does not have. Whether anything answered is
+     * up to the caller, a transport cannot tell an unconnected MISO.
+     *
+     * @return false if this transport cannot read
+     */
+    virtual bool read(const void* /* data */, void* /* response */, size_t /* size */) { return false; }
+};
+
+} // namespace ht1632
@@ -1,10 +1,11 @@
 #include <nlohmann/json.hpp>
 #include <mosquitto.h>
 #include <chrono>
+#include <thread>
 
 #include "ha_discovery.hpp"
 #include "log_util.hpp"
-#include "utf8_converter.hpp"
+#include "font.hpp"
 #include "display.hpp"
 #include "timer.hpp"
 
@@ -194,10 +195,10 @@ void HADiscoveryManager::publishDeviceState(struct mosquitto* mosq, const std::s
         display_content = "<empty>";
     }
     
-    // Convert Latin1 display content to UTF-8 for Home Assistant
+    // Convert the glyph indices back to UTF-8 for Home Assistant
     std::string utf8_display_content;
     try {
-        utf8_display_content = utf8::toUtf8(display_content);
+        utf8_display_content = font::fromGlyphs(display_content);
     } catch (const std::exception& e) {
         ERROR_LOG("Failed to convert display content to UTF-8: " << e.what());
         utf8_display_content = display_content; // Use original as fallback
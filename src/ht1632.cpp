@@ -4,274 +4,353 @@
 #include <wiringPi.h>
 #include <wiringPiSPI.h>
 #include <unistd.h>
-#include <vector>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include <array>
 #include <chrono>
+#include <iterator>
+#include <memory>
+#include <vector>
 
 #include "display.hpp"
 #include "display_impl.hpp"
+#include "frame_output.hpp"
 #include "ht1632.hpp"
+#include "ht1632_driver.hpp"
 #include "log_util.hpp"
+#include "parallel_writer.hpp"
+#include "spidev_transport.hpp"
 
 namespace ht1632
 {
 
-int spifd = -1;
-
-int cs_pins[] = {HT1632_PANEL_PINS};
-int panel_count = sizeof(cs_pins) / sizeof(cs_pins[0]);
-
-// Stability tracking for display health monitoring
-static std::chrono::steady_clock::time_point last_reinit_time = std::chrono::steady_clock::now();
-
-static void select_chip(int pin)
+/**
+ * @brief Transport using wiringPi for the chip selects and delays
+ */
+class WiringPiTransport : public Transport
 {
-    for (int i = 0; i < panel_count; ++i)
+public:
+    /**
+     * @param channel SPI0 chip enable the chain is on, 0 or 1
+     * @param pins Chip select of each panel on the chain
+     */
+    WiringPiTransport(int channel, std::vector<int> pins)
+        : cs_pins(std::move(pins))
     {
-        if (pin == HT1632_PANEL_ALL)
+        static bool setup_done = false;
+        if (!setup_done && wiringPiSetup() == -1)
         {
-            digitalWrite(cs_pins[i], LOW);
+            perror("WiringPi Setup Failed");
+            exit(EXIT_FAILURE);
         }
-        else if (pin == HT1632_PANEL_NONE)
+        setup_done = true;
+
+        spifd = wiringPiSPISetup(channel, HT1632_SPI_FREQ);
+        if (spifd < 0)
         {
-            digitalWrite(cs_pins[i], HIGH);
+            perror("SPI Setup Failed");
+            exit(EXIT_FAILURE);
         }
-        else
+
+        /* set cs pins to output */
+        for (int pin : cs_pins)
         {
-            digitalWrite(cs_pins[i], cs_pins[i] == pin ? LOW : HIGH);
+            pinMode(pin, OUTPUT);
         }
     }
-    // Increased delay for better signal integrity, especially for 4th panel
-    // HT1632 requires minimum 1μs setup time, using 5μs for stability
-    delayMicroseconds(5);
-}
 
+    ~WiringPiTransport() override
+    {
+        close(spifd);
+    }
+
+    void select(int panel, uint16_t setup_delay_us) override
+    {
+        for (size_t i = 0; i < cs_pins.size(); ++i)
+        {
+            if (panel == HT1632_PANEL_ALL)
+            {
+                digitalWrite(cs_pins[i], LOW);
+            }
+            else if (panel == HT1632_PANEL_NONE)
+            {
+                digitalWrite(cs_pins[i], HIGH);
+            }
+            else
+            {
+                digitalWrite(cs_pins[i], static_cast<int>(i) == panel ? LOW : HIGH);
+            }
+        }
+        // Increased delay for better signal integrity, especially for 4th panel
+        delayMicroseconds(setup_delay_us);
+    }
+
+    void write(const void *buffer, size_t size, uint16_t delay_us) override
+    {
+        transfer(buffer, nullptr, size, delay_us);
+    }
+
+    bool read(const void *buffer, void *response, size_t size) override
+    {
+        transfer(buffer, response, size, 0);
+        return true;
+    }
+
+private:
+    void transfer(const void *buffer, void *response, size_t size, uint16_t delay_us)
+    {
+        // Straight from the caller's buffer, unlike wiringPiSPIDataRW which
+        // overwrites it with the received data
+        spi_ioc_transfer transfer{};
+        transfer.tx_buf = reinterpret_cast<uintptr_t>(buffer);
+        transfer.rx_buf = reinterpret_cast<uintptr_t>(response);
+        transfer.len = static_cast<uint32_t>(size);
+        transfer.speed_hz = HT1632_SPI_FREQ;
+        transfer.bits_per_word = 8;
+
+        int result = ioctl(spifd, SPI_IOC_MESSAGE(1), &transfer);
+
+        if (result == -1)
+        {
+            perror("SPI write failed");
+            exit(EXIT_FAILURE);
+        }
+
+        delayMicroseconds(delay_us);
+    }
 
+    std::vector<int> cs_pins;
+    int spifd = -1;
+};
 
-static void ht1632_write(const void *buffer, size_t size)
+#ifdef HT1632_USE_SPIDEV
+static const char* spi_devices[] = {HT1632_SPI_DEVICES};
+static const int default_cs_pins[] = {HT1632_PANEL_LINES};
+#else
+static const int default_cs_pins[] = {HT1632_PANEL_PINS};
+#endif
+
+// Chip selects from the geometry, HT1632_PANEL_PINS or HT1632_PANEL_LINES when it has none
+static std::vector<int> chipSelects(const display::Geometry& geometry)
 {
-    // Create a copy since wiringPiSPIDataRW modifies the buffer
-    std::vector<unsigned char> data(static_cast<const unsigned char*>(buffer), 
-                                   static_cast<const unsigned char*>(buffer) + size);
-    
-    int result = wiringPiSPIDataRW(0, data.data(), static_cast<int>(size));
-    
-    if (result == -1)
+    if (!geometry.cs_pins.empty())
     {
-        perror("SPI write failed");
+        return geometry.cs_pins;
+    }
+
+    std::vector<int> pins(std::begin(default_cs_pins), std::end(default_cs_pins));
+    if (pins.size() != geometry.panel_count)
+    {
+        LOG("DISPLAY_CS_PINS is required for " << geometry.panel_count << " panels, the defaults cover " << pins.size());
         exit(EXIT_FAILURE);
     }
+    return pins;
 }
 
-static void send_cmd(int pin, uint8_t cmd)
+// Transport for one chain, chain i is on the i-th SPI device (channel for wiringPi)
+static std::unique_ptr<Transport> createTransport(const display::Geometry& geometry, size_t chain)
 {
-    // HT1632 Command Protocol: 12 bits total
-    // Format: [3-bit ID][8-bit command][1 padding bit] = 12 bits
-    uint16_t data = static_cast<uint16_t>(((HT1632_ID_CMD << 8) | cmd) << 1);
-    
-    // Convert to bytes for SPI (12 bits = 1.5 bytes, so use 2 bytes)
-    uint8_t spi_data[2];
-    spi_data[0] = static_cast<uint8_t>((data >> 4) & 0xFF);    // Upper 8 bits
-    spi_data[1] = static_cast<uint8_t>((data << 4) & 0xF0);    // Lower 4 bits, left-aligned
-
-    piLock(HT1632_WIREPI_LOCK_ID);
-
-    select_chip(pin);
-    ht1632_write(spi_data, 2);
-    // Add small delay before deselecting for better signal integrity
-    delayMicroseconds(2);
-    select_chip(HT1632_PANEL_NONE);
-
-    piUnlock(HT1632_WIREPI_LOCK_ID);
-}
+    const auto all_pins = chipSelects(geometry);
+    const auto first = all_pins.begin() + static_cast<std::ptrdiff_t>(geometry.firstPanelOf(chain));
+    std::vector<int> pins(first, first + static_cast<std::ptrdiff_t>(geometry.panelsIn(chain)));
 
-static void initialize_displays()
-{
-    send_cmd(HT1632_PANEL_ALL, HT1632_CMD_SYS_EN);
-    delayMicroseconds(50);
-    send_cmd(HT1632_PANEL_ALL, HT1632_CMD_COM);
-    delayMicroseconds(50);
-    send_cmd(HT1632_PANEL_ALL, HT1632_CMD_LED_ON);
-    delayMicroseconds(50);
-    send_cmd(HT1632_PANEL_ALL, HT1632_CMD_BLINK_OFF);
-    delayMicroseconds(50);
+#ifdef HT1632_USE_SPIDEV
+    if (chain >= std::size(spi_devices))
+    {
+        LOG("Only " << std::size(spi_devices) << " chains are configured in HT1632_SPI_DEVICES");
+        exit(EXIT_FAILURE);
+    }
 
-    last_reinit_time = std::chrono::steady_clock::now();
+    std::vector<uint32_t> lines(pins.begin(), pins.end());
+    auto transport = SpidevTransport::open(spi_devices[chain], HT1632_GPIO_CHIP, lines, HT1632_SPI_FREQ);
+    if (!transport)
+    {
+        perror("SPI Setup Failed");
+        exit(EXIT_FAILURE);
+    }
+    return transport;
+#else
+    if (chain > 1)
+    {
+        LOG("WiringPi supports two chains (SPI0 CE0/CE1), use HT1632_USE_SPIDEV for more");
+        exit(EXIT_FAILURE);
+    }
+
+    return std::make_unique<WiringPiTransport>(static_cast<int>(chain), std::move(pins));
+#endif
 }
 
-} // namespace ht1632
+#ifdef HT1632_VERIFY_READBACK
+static constexpr bool VERIFY_READBACK = true;
+#else
+static constexpr bool VERIFY_READBACK = false;
+#endif
 
-namespace display
-{
+// One transport and driver per chain
+static std::vector<std::unique_ptr<Transport>> transports;
+static std::vector<std::unique_ptr<Driver>> drivers;
 
-static void init()
+// Writes every chain's part of a frame in parallel
+static std::unique_ptr<ParallelWriter> writer;
+
+// Stability tracking for display health monitoring
+static std::chrono::steady_clock::time_point last_reinit_time = std::chrono::steady_clock::now();
+static std::chrono::steady_clock::time_point last_verify_time = std::chrono::steady_clock::now();
+static bool readback_available = VERIFY_READBACK;
+
+// Frames are written to the panels from here so rendering never waits on SPI
+static std::unique_ptr<FrameOutput> output;
+
+static void send_command(uint8_t command, uint16_t delay_us = 2)
 {
-    /* set cs pins to output */
-    for (int i = 0; i < ht1632::panel_count; ++i)
+    for (auto& driver : drivers)
     {
-        pinMode(ht1632::cs_pins[i], OUTPUT);
+        driver->sendCommand(HT1632_PANEL_ALL, command, delay_us);
     }
+}
 
-    ht1632::send_cmd(HT1632_PANEL_ALL, HT1632_CMD_SYS_DIS);
-    ht1632::initialize_displays();
+static void initialize_displays()
+{
+    for (auto& driver : drivers)
+    {
+        driver->initialize();
+    }
+    last_reinit_time = std::chrono::steady_clock::now();
 }
 
+} // namespace ht1632
+
+namespace display
+{
+
 DisplayImpl::DisplayImpl(
+    const Geometry& geometry,
     std::function<void()> preUpdate,
     std::function<void()> postUpdate,
     DisplayStateCallback stateCallback,
     std::function<void()> scrollCompleteCallback
 )
-    : Display(preUpdate, postUpdate, stateCallback, scrollCompleteCallback)
+    : Display(geometry.width(), preUpdate, postUpdate, stateCallback, scrollCompleteCallback)
 {
-    if (wiringPiSetup() == -1)
+    auto error = geometry.validate();
+    if (!error.empty())
     {
-        perror("WiringPi Setup Failed");
+        LOG("Invalid display geometry: " << error);
         exit(EXIT_FAILURE);
     }
 
-    ht1632::spifd = wiringPiSPISetup(0, HT1632_SPI_FREQ);
-    if (!ht1632::spifd)
+    LOG("Display: " << geometry.panel_count << " panels of " << geometry.panel_width << " columns"
+        << (geometry.flip ? ", flipped" : ""));
+
+    std::vector<ht1632::ParallelWriter::Chain> chains;
+    for (size_t chain = 0; chain < geometry.chainCount(); ++chain)
     {
-        perror("SPI Setup Failed");
-        exit(EXIT_FAILURE);
+        auto& transport = ht1632::transports.emplace_back(ht1632::createTransport(geometry, chain));
+        auto* driver = ht1632::drivers.emplace_back(std::make_unique<ht1632::Driver>(*transport, geometry, chain)).get();
+        chains.push_back([driver](const ht1632::Frame& frame) { driver->writeFrame(frame); });
     }
+    ht1632::writer = std::make_unique<ht1632::ParallelWriter>(std::move(chains));
 
-    if (X_MAX != (HT1632_PANEL_WIDTH * ht1632::panel_count))
+    if (geometry.chainCount() > 1)
     {
-        LOG("Display area (X_MAX) must be equal to total panel columns.");
-        LOG("X_MAX: " << X_MAX);
-        LOG("Panel columns: " << (HT1632_PANEL_WIDTH * ht1632::panel_count) << ", (" << HT1632_PANEL_WIDTH << " * " << ht1632::panel_count << ")");
-        exit(EXIT_FAILURE);
+        LOG("Writing " << geometry.chainCount() << " chains in parallel");
     }
 
-    init();
+    ht1632::send_command(HT1632_CMD_SYS_DIS);
+    ht1632::initialize_displays();
     setBrightness(DEFAULT_BRIGHTNESS);
 
+    ht1632::output = std::make_unique<ht1632::FrameOutput>([this](const ht1632::Frame& frame) { writeFrame(frame); });
+
     LOG("Display enabled");
 }
 
 DisplayImpl::~DisplayImpl()
 {
-    ht1632::send_cmd(HT1632_PANEL_ALL, HT1632_CMD_LED_OFF);
-    ht1632::send_cmd(HT1632_PANEL_ALL, HT1632_CMD_SYS_DIS);
+    // No more frames may be submitted once the output stage is gone
+    stop();
+    ht1632::output->stop();
+
+    auto output_stats = ht1632::output->getStats();
+    LOG("Output frames written: " << output_stats.frames_written << ", dropped: " << output_stats.frames_dropped
+        << ", queue latency avg " << std::chrono::duration_cast<std::chrono::microseconds>(output_stats.average_latency).count()
+        << "us, worst " << std::chrono::duration_cast<std::chrono::microseconds>(output_stats.worst_latency).count() << "us");
+    ht1632::output.reset();
+
+    auto frame_stats = getFrameStats();
+    LOG("Display frames: " << frame_stats.frames << ", over the " << 1000 / getRefreshRate() << "ms budget: " << frame_stats.frames_over_budget
+        << ", frame time avg " << std::chrono::duration_cast<std::chrono::microseconds>(frame_stats.average_frame_time).count()
+        << "us, worst " << std::chrono::duration_cast<std::chrono::microseconds>(frame_stats.worst_frame_time).count() << "us");
+
+    auto chain_stats = ht1632::writer->getStats();
+    LOG("Chain frame time avg " << std::chrono::duration_cast<std::chrono::microseconds>(chain_stats.average_frame).count()
+        << "us, worst " << std::chrono::duration_cast<std::chrono::microseconds>(chain_stats.worst_frame).count() << "us");
+    ht1632::writer.reset();
+
+    for (size_t chain = 0; chain < ht1632::drivers.size(); ++chain)
+    {
+        auto stats = ht1632::drivers[chain]->getTransferStats();
+        LOG("Chain " << chain << " SPI panels written: " << stats.panels_written << " (" << stats.panels_partial << " partial, "
+            << stats.bytes_written << " bytes), skipped: "
+            << stats.panels_skipped << " (" << stats.bytes_skipped << " bytes)");
+        LOG("Chain " << chain << " panel commands sent: " << stats.commands_sent << ", already in effect: " << stats.commands_suppressed);
+
+        auto health = ht1632::drivers[chain]->getHealthStats();
+        LOG("Chain " << chain << " panel readback checks: " << health.panels_verified << ", corrupted: " << health.corruptions_detected
+            << ", repaired: " << health.panels_repaired);
+    }
 
-    close(ht1632::spifd);
+    ht1632::send_command(HT1632_CMD_LED_OFF);
+    ht1632::send_command(HT1632_CMD_SYS_DIS);
+
+    ht1632::drivers.clear();
+    ht1632::transports.clear();
 }
 
 void DisplayImpl::setBrightness(int brightness)
 {
     currentBrightness = brightness & 0xF;  // Store for restoration after reinitialization and update base class tracking
-    ht1632::send_cmd(HT1632_PANEL_ALL, HT1632_CMD_PWM + static_cast<uint8_t>(currentBrightness));
-}
-
-// Helper function to reverse bits in a byte (for 180-degree flip)
-static constexpr uint8_t reverse_bits(uint8_t byte) {
-    return static_cast<uint8_t>(((byte & 0x01) << 7) | ((byte & 0x02) << 5) | ((byte & 0x04) << 3) | ((byte & 0x08) << 1) |
-                                ((byte & 0x10) >> 1) | ((byte & 0x20) >> 3) | ((byte & 0x40) >> 5) | ((byte & 0x80) >> 7));
+    ht1632::send_command(HT1632_CMD_PWM + static_cast<uint8_t>(brightness & 0xF));
 }
 
-// Helper function to pack bits into buffer at given position
-static void packBit(std::array<unsigned char, 34>& buffer, size_t& bit_pos, bool pixel_on)
-{
-    if (pixel_on) {
-        const size_t byte_pos = bit_pos / 8;
-        const size_t bit_offset = 7 - (bit_pos % 8);  // MSB first
-        if (byte_pos < 34) {
-            buffer[byte_pos] |= static_cast<uint8_t>(1 << bit_offset);
-        }
-    }
-    bit_pos++;
-}
-
-// Helper function to extract column pixels with flip handling
-static uint8_t getColumnPixels(const std::array<uint8_t, X_MAX>& displayBuffer, int panel, int col)
+void DisplayImpl::update()
 {
-    const size_t offset = static_cast<size_t>(panel * HT1632_PANEL_WIDTH);
-    const size_t src_index = offset + static_cast<size_t>(col);
-    
-    if (src_index >= X_MAX) {
-        return 0;
-    }
-    
-#ifdef HT1632_FLIP_180
-    // Calculate flipped position
-    const size_t flipped_panel_base = static_cast<size_t>(3 - panel) * HT1632_PANEL_WIDTH;
-    const size_t flipped_col = flipped_panel_base + static_cast<size_t>(HT1632_PANEL_WIDTH - 1 - col);
-    
-    if (flipped_col >= X_MAX) {
-        return 0;
-    }
-    
-    // Reverse bit order for 180° flip
-    return reverse_bits(static_cast<uint8_t>(displayBuffer[flipped_col]));
-#else
-    return static_cast<uint8_t>(displayBuffer[src_index]);
-#endif
+    ht1632::output->submit(displayBuffer);
 }
 
-// Helper function to pack column pixels into buffer
-static void packColumnPixels(std::array<unsigned char, 34>& buffer, size_t& bit_pos, uint8_t column_pixels, int num_rows)
+// Runs on the output thread
+void DisplayImpl::writeFrame(const Framebuffer& frame)
 {
-    for (int row = 0; row < num_rows; ++row) {
-        const bool pixel_on = (column_pixels & (1 << row)) != 0;
-        packBit(buffer, bit_pos, pixel_on);
-    }
-}
+#ifdef HT1632_ENABLE_HEALTH_MONITORING
+    auto now = std::chrono::steady_clock::now();
 
-static std::array<unsigned char, 34> createWriteBuffer(std::array<uint8_t, X_MAX> displayBuffer, int panel)
-{
-    std::array<unsigned char, 34> buffer = {0};
-    size_t bit_pos = 0;
-    
-    // Phase 1: Write header (10 bits)
-    // Header: Write command (3 bits) + Address 0 (7 bits) = 10 bits
-    const uint16_t header = (HT1632_ID_WRITE << 7) | 0x00;
-    buffer[0] = static_cast<uint8_t>((header >> 2) & 0xFF);        // Upper 8 bits
-    buffer[1] = static_cast<uint8_t>((header << 6) & 0xC0);        // Lower 2 bits
-    bit_pos = 10;
-    
-    // Phase 2: Process regular pixels (32 columns × 8 rows = 256 bits)
-    for (int col = 0; col < HT1632_PANEL_WIDTH; ++col) {
-        const uint8_t column_pixels = getColumnPixels(displayBuffer, panel, col);
-        packColumnPixels(buffer, bit_pos, column_pixels, 8);
+    // Check one panel per interval, only panels that fail are reinitialized
+    if (ht1632::readback_available && now - ht1632::last_verify_time >= std::chrono::seconds(HT1632_VERIFY_INTERVAL_SECONDS))
+    {
+        ht1632::last_verify_time = now;
+        for (auto& driver : ht1632::drivers)
+        {
+            if (!driver->verifyNextPanel())
+            {
+                WARN_LOG("Panel readback is not supported by the transport or nothing answered, using periodic reinitialization");
+                ht1632::readback_available = false;
+                break;
+            }
+        }
     }
-    
-    // Phase 3: Add duplicate pixels for SPI alignment (6 bits from first column)
-    // This prevents wrap-around corruption by duplicating first 6 pixels of column 0
-    const uint8_t first_column_pixels = getColumnPixels(displayBuffer, panel, 0);
-    packColumnPixels(buffer, bit_pos, first_column_pixels, 6);
-    
-    return buffer;
-}
 
-void DisplayImpl::update()
-{
     // Time-based periodic reinitialization to prevent state corruption
-#ifdef HT1632_ENABLE_HEALTH_MONITORING
-    auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::minutes>(now - ht1632::last_reinit_time);
-    
-    if (elapsed.count() >= HT1632_REINIT_INTERVAL_MINUTES)
+
+    if (!ht1632::readback_available && elapsed.count() >= HT1632_REINIT_INTERVAL_MINUTES)
     {
         ht1632::initialize_displays();
         // Restore current brightness after reinitialization
         setBrightness(currentBrightness);
     }
 #endif
-    
-    piLock(HT1632_WIREPI_LOCK_ID);
-
-    for (int i = 0; i < ht1632::panel_count; ++i)
-    {
-        ht1632::select_chip(ht1632::cs_pins[i]);
-        delayMicroseconds(2);
-
-        auto buffer = createWriteBuffer(displayBuffer, i);
-        ht1632::ht1632_write(buffer.data(), buffer.size());
-        delayMicroseconds(2);
-    }
 
-    piUnlock(HT1632_WIREPI_LOCK_ID);
+    ht1632::writer->write(frame);
 }
 
 } // namespace display
@@ -1,19 +1,28 @@
 #ifndef ht1632_hpp
 #define ht1632_hpp
 
-#define HT1632_WIREPI_LOCK_ID 0
-
-/* Display settings */
-#define HT1632_PANEL_WIDTH      X_MAX / 4       /* column/pixel width of each panel */
-#define HT1632_PANEL_PINS       8, 9, 15, 16    /* wiringPi pins - reordered for correct panel sequence */
+/* Display settings, panel count, width and flip come from display::Geometry */
+#define HT1632_PANEL_PINS       8, 9, 15, 16    /* default wiringPi pins - reordered for correct panel sequence */
 #define HT1632_SPI_FREQ         200000          /* Hz */
 
 /* Display stability settings */
 #define HT1632_REINIT_INTERVAL_MINUTES  1      /* Reinitialize every N minutes (time-based) */
 #define HT1632_ENABLE_HEALTH_MONITORING         /* Enable periodic reinitialization */
 
-/* Define HT1632_FLIP_180 to mount the display upside down */
-#define HT1632_FLIP_180
+/* Define HT1632_VERIFY_READBACK to read back one panel's RAM every interval and only
+   reinitialize panels that lost their contents. Needs the data line readable on MISO
+   and RD wired, falls back to periodic reinitialization if the transport cannot read
+   or the first response does not echo the read ID, as with MISO left unconnected */
+/* #define HT1632_VERIFY_READBACK */
+#define HT1632_VERIFY_INTERVAL_SECONDS  15
+
+/* Define HT1632_USE_SPIDEV to drive the bus through spidev and the chip selects
+   through the GPIO character device instead of wiringPi. Chains (DISPLAY_CHAINS)
+   only refresh in parallel when they are on different SPI controllers */
+/* #define HT1632_USE_SPIDEV */
+#define HT1632_SPI_DEVICES      "/dev/spidev0.0", "/dev/spidev1.0", "/dev/spidev0.1"  /* one per chain */
+#define HT1632_GPIO_CHIP        "/dev/gpiochip0"
+#define HT1632_PANEL_LINES      2, 3, 14, 15    /* GPIO line offsets of HT1632_PANEL_PINS */
 
 #define HT1632_PANEL_NONE       -1
 #define HT1632_PANEL_ALL        0xff
@@ -96,12 +96,13 @@ static void showAlignment(display::Alignment align)
 }
 
 DisplayImpl::DisplayImpl(
+    const Geometry& geometry,
     std::function<void()> preUpdate,
     std::function<void()> postUpdate,
     DisplayStateCallback stateCallback,
     std::function<void()> scrollCompleteCallback
 )
-    : Display(preUpdate, postUpdate, stateCallback, scrollCompleteCallback)
+    : Display(geometry.width(), preUpdate, postUpdate, stateCallback, scrollCompleteCallback)
 {
     debug::Logger::enableFileLogging("display.log");
 
@@ -134,13 +135,14 @@ void DisplayImpl::update()
     clear();
     float elapsed = getElapsed();
 
-    int row, i;
+    int row;
+    size_t i;
     for (row = -1; row <= 8; row++)
     {
         if (row == -1)
         {
             addch(ACS_ULCORNER);
-            for (i = 0; i < X_MAX + 2; i++)
+            for (i = 0; i < displayWidth + 2; i++)
                 addch(ACS_HLINE);
             addch(ACS_URCORNER);
             addch('\n');
@@ -150,7 +152,7 @@ void DisplayImpl::update()
         if (row == 8)
         {
             addch(ACS_LLCORNER);
-            for (i = 0; i < X_MAX + 2; i++)
+            for (i = 0; i < displayWidth + 2; i++)
                 addch(ACS_HLINE);
             addch(ACS_LRCORNER);
             addch('\n');
@@ -161,10 +163,9 @@ void DisplayImpl::update()
         addch(ACS_VLINE);
         addch(' ');
 
-        int col;
-        for (col = 0; col < X_MAX; col++)
+        for (size_t col = 0; col < displayWidth; col++)
         {
-            if (displayBuffer[static_cast<size_t>(col)] & (1 << row))
+            if (displayBuffer[col] & (1 << row))
                 addch(ACS_CKBOARD);
             else
                 addch(' ');
@@ -322,6 +322,13 @@ static void print_usage(const char* prog_name) {
     LOG("  MQTT_CLIENT_ID   - MQTT client ID (default: raspberry-display)");
     LOG("  MQTT_TOPIC_PREFIX- Topic prefix (default: display)");
     LOG("  HA_REPORTING     - Enable Home Assistant reporting (true|false) (default: false)");
+    LOG("  DISPLAY_PANELS   - Number of panels in the chain (default: " << DEFAULT_PANEL_COUNT << ")");
+    LOG("  DISPLAY_PANEL_WIDTH - Columns per panel, 8|16|24|32 (default: " << DEFAULT_PANEL_WIDTH << ")");
+    LOG("  DISPLAY_CS_PINS  - Chip select pin per panel, comma separated (default: built-in)");
+    LOG("  DISPLAY_FLIP     - Display mounted upside down (true|false)");
+    LOG("  DISPLAY_PANEL_ORDER - Column block shown by each panel, comma separated (default: 0,1,2,...)");
+    LOG("  DISPLAY_CHAINS   - Panels per chain, chains are written in parallel (default: one chain)");
+    LOG("  DISPLAY_REFRESH_RATE - Frame rate while animating, up to " << MAX_REFRESH_RATE << " Hz (default: " << REFRESH_RATE << ")");
     LOG("");
     LOG("Examples:");
     LOG("  " << prog_name << " localhost 1883");
@@ -429,8 +436,17 @@ int main(int argc, char** argv) {
         sequence_manager->onScrollComplete();
     };
     
-    auto display = std::make_unique<display::DisplayImpl>(preUpdate, postUpdate, displayStateCallback, scrollCompleteCallback);
+    auto geometry = display::Geometry::fromEnvironment();
+    auto refresh_rate = display::refreshRateFromEnvironment(REFRESH_RATE, MAX_REFRESH_RATE);
+    if (!geometry || !refresh_rate) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    auto display = std::make_unique<display::DisplayImpl>(*geometry, preUpdate, postUpdate, displayStateCallback, scrollCompleteCallback);
     global_display = display.get(); // Keep pointer for signal handling
+
+    display->setRefreshRate(*refresh_rate);
     
     // Initialize mosquitto library
     mosquitto_lib_init();
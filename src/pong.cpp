@@ -9,7 +9,8 @@
 namespace pong
 {
 
-PongGame::PongGame()
+PongGame::PongGame(size_t field_width)
+    : m_fieldWidth(static_cast<int>(field_width))
 {
     // Initialize random seed for ball movement
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
@@ -58,7 +59,7 @@ void PongGame::setPlayerControl(PaddleControl control)
 
 void PongGame::reset()
 {
-    m_ball = Ball();
+    m_ball = Ball(static_cast<float>(m_fieldWidth));
     m_playerPaddle = Paddle();
     m_aiPaddle = Paddle();
     m_gameOver = false;
@@ -183,10 +184,10 @@ void PongGame::checkCollisions()
     }
     
     // Right paddle collision (AI)
-    if (m_ball.x >= PONG_FIELD_WIDTH - 3 && m_ball.dx > 0) {
+    if (m_ball.x >= static_cast<float>(m_fieldWidth - 3) && m_ball.dx > 0) {
         if (m_ball.y >= m_aiPaddle.y && m_ball.y <= m_aiPaddle.y + PONG_PADDLE_HEIGHT) {
             m_ball.dx = -m_ball.dx;
-            m_ball.x = PONG_FIELD_WIDTH - 3;
+            m_ball.x = static_cast<float>(m_fieldWidth - 3);
             // Add some spin based on where the ball hits the paddle (reduced spin)
             float hitPos = (m_ball.y - m_aiPaddle.y) / PONG_PADDLE_HEIGHT;
             m_ball.dy += (hitPos - 0.5f) * 0.3f;
@@ -211,7 +212,7 @@ void PongGame::checkScore()
     if (m_ball.x < 0) {
         m_aiPaddle.score++;
         resetBall();
-    } else if (m_ball.x >= PONG_FIELD_WIDTH) {
+    } else if (m_ball.x >= static_cast<float>(m_fieldWidth)) {
         m_playerPaddle.score++;
         resetBall();
     }
@@ -225,7 +226,7 @@ void PongGame::checkScore()
 
 void PongGame::resetBall()
 {
-    m_ball.x = PONG_FIELD_WIDTH / 2.0f;
+    m_ball.x = static_cast<float>(m_fieldWidth) / 2.0f;
     m_ball.y = PONG_FIELD_HEIGHT / 2.0f;
     
     // Random direction
@@ -233,10 +234,10 @@ void PongGame::resetBall()
     m_ball.dy = ((static_cast<float>(std::rand() % 100)) / 100.0f - 0.5f) * 1.0f;
 }
 
-void PongGame::renderToBuffer(std::array<uint8_t, X_MAX>& buffer)
+void PongGame::renderToBuffer(display::Framebuffer& buffer)
 {
     // Clear buffer
-    buffer.fill(0);
+    std::fill(buffer.begin(), buffer.end(), 0);
     
     if (m_gameOver) {
         // Show game over text using the font system
@@ -248,15 +249,15 @@ void PongGame::renderToBuffer(std::array<uint8_t, X_MAX>& buffer)
         }
         
         // Render the text using the font system
-        std::vector<uint8_t> renderedText = font::FontCache::renderStringOptimized(winText);
+        const auto renderedText = font::renderString(winText);
         
         // Center the text horizontally on the display
         int textWidth = static_cast<int>(renderedText.size());
-        int startX = (PONG_FIELD_WIDTH - textWidth) / 2;
+        int startX = (m_fieldWidth - textWidth) / 2;
         
         // Ensure we don't go outside buffer bounds
         startX = std::max(0, startX);
-        int endX = std::min(PONG_FIELD_WIDTH, startX + textWidth);
+        int endX = std::min(m_fieldWidth, startX + textWidth);
         
         // Copy the rendered text to the buffer
         for (int x = startX; x < endX; x++) {
@@ -270,24 +271,24 @@ void PongGame::renderToBuffer(std::array<uint8_t, X_MAX>& buffer)
     
     // Render game elements
     renderPaddle(buffer, 1, m_playerPaddle);                    // Left paddle
-    renderPaddle(buffer, PONG_FIELD_WIDTH - 2, m_aiPaddle);     // Right paddle
+    renderPaddle(buffer, m_fieldWidth - 2, m_aiPaddle);         // Right paddle
     renderBall(buffer, m_ball);
     renderScore(buffer);
 }
 
-void PongGame::renderPaddle(std::array<uint8_t, X_MAX>& buffer, int x, const Paddle& paddle)
+void PongGame::renderPaddle(display::Framebuffer& buffer, int x, const Paddle& paddle)
 {
     for (int i = 0; i < PONG_PADDLE_HEIGHT; i++) {
         setPixel(buffer, x, static_cast<int>(paddle.y) + i, true);
     }
 }
 
-void PongGame::renderBall(std::array<uint8_t, X_MAX>& buffer, const Ball& ball)
+void PongGame::renderBall(display::Framebuffer& buffer, const Ball& ball)
 {
     setPixel(buffer, static_cast<int>(ball.x), static_cast<int>(ball.y), true);
 }
 
-void PongGame::renderScore(std::array<uint8_t, X_MAX>& buffer)
+void PongGame::renderScore(display::Framebuffer& buffer)
 {
     // Simple score display using pixels at the top
     // Player score on the left side (pixels 20-30)
@@ -295,20 +296,20 @@ void PongGame::renderScore(std::array<uint8_t, X_MAX>& buffer)
         setPixel(buffer, 20 + i * 2, 0, true);
     }
     
-    // AI score on the right side (pixels 98-108)
+    // AI score on the right side, mirroring the player's
     for (int i = 0; i < std::min(m_aiPaddle.score, 10); i++) {
-        setPixel(buffer, 98 + i * 2, 0, true);
+        setPixel(buffer, m_fieldWidth - 30 + i * 2, 0, true);
     }
     
     // Center line
     for (int y = 1; y < PONG_FIELD_HEIGHT - 1; y += 2) {
-        setPixel(buffer, PONG_FIELD_WIDTH / 2, y, true);
+        setPixel(buffer, m_fieldWidth / 2, y, true);
     }
 }
 
-void PongGame::setPixel(std::array<uint8_t, X_MAX>& buffer, int x, int y, bool on)
+void PongGame::setPixel(display::Framebuffer& buffer, int x, int y, bool on)
 {
-    if (x < 0 || x >= PONG_FIELD_WIDTH || y < 0 || y >= PONG_FIELD_HEIGHT) {
+    if (x < 0 || x >= m_fieldWidth || y < 0 || y >= PONG_FIELD_HEIGHT) {
         return;
     }
     
@@ -12,7 +12,6 @@
 #define PONG_PADDLE_HEIGHT 2
 #define PONG_PADDLE_WIDTH 1
 #define PONG_BALL_SIZE 1
-#define PONG_FIELD_WIDTH X_MAX
 #define PONG_FIELD_HEIGHT 8
 #define PONG_AI_SPEED 0.4f
 #define PONG_WINNING_SCORE 3
@@ -39,7 +38,7 @@ struct Ball
     float x, y;
     float dx, dy;
     
-    Ball() : x(PONG_FIELD_WIDTH / 2.0f), y(PONG_FIELD_HEIGHT / 2.0f), 
+    explicit Ball(float field_width = 0.0f) : x(field_width / 2.0f), y(PONG_FIELD_HEIGHT / 2.0f), 
              dx(-1.0f), dy(0.5f) {}
 };
 
@@ -54,7 +53,8 @@ struct Paddle
 class PongGame
 {
 public:
-    PongGame();
+    // Field spans the whole display width
+    explicit PongGame(size_t field_width);
     ~PongGame();
     
     // Game control
@@ -66,7 +66,7 @@ public:
     void setPlayerControl(PaddleControl control);
     
     // Display integration
-    void renderToBuffer(std::array<uint8_t, X_MAX>& buffer);
+    void renderToBuffer(display::Framebuffer& buffer);
     
     // Game state
     void reset();
@@ -83,11 +83,12 @@ private:
     void resetBall();
     
     // Rendering helpers
-    void renderPaddle(std::array<uint8_t, X_MAX>& buffer, int x, const Paddle& paddle);
-    void renderBall(std::array<uint8_t, X_MAX>& buffer, const Ball& ball);
-    void renderScore(std::array<uint8_t, X_MAX>& buffer);
-    void setPixel(std::array<uint8_t, X_MAX>& buffer, int x, int y, bool on = true);
+    void renderPaddle(display::Framebuffer& buffer, int x, const Paddle& paddle);
+    void renderBall(display::Framebuffer& buffer, const Ball& ball);
+    void renderScore(display::Framebuffer& buffer);
+    void setPixel(display::Framebuffer& buffer, int x, int y, bool on = true);
     
+    const int m_fieldWidth;
     Ball m_ball;
     Paddle m_playerPaddle;    // Left paddle (user controlled)
     Paddle m_aiPaddle;        // Right paddle (AI controlled)
@@ -6,16 +6,21 @@
 #include <string>
 #include <array>
 #include <functional>
+#include <thread>
+#include <chrono>
 
 #include <catch2/catch_all.hpp>
 
 #include "display.hpp"
+#include "font.hpp"
 #include "transition.hpp"
 
 #define CATCH_CONFIG_MAIN
 
 namespace display {
 
+static constexpr size_t WIDTH = 128;
+
 // TestDisplayImpl - Mock implementation for testing Display class
 class TestDisplayImpl : public Display {
 public:
@@ -23,8 +28,9 @@ public:
         std::function<void()> preUpdate = [](){},
         std::function<void()> postUpdate = [](){},
         DisplayStateCallback stateCallback = nullptr,
-        std::function<void()> scrollCompleteCallback = [](){}
-    ) : Display(preUpdate, postUpdate, stateCallback, scrollCompleteCallback),
+        std::function<void()> scrollCompleteCallback = [](){},
+        size_t width = WIDTH
+    ) : Display(width, preUpdate, postUpdate, stateCallback, scrollCompleteCallback),
         brightness_set_count(0),
         update_count(0),
         last_brightness(DEFAULT_BRIGHTNESS) {}
@@ -39,11 +45,13 @@ public:
     int getBrightnessSetCount() const { return brightness_set_count; }
     int getUpdateCount() const { return update_count; }
     int getLastBrightness() const { return last_brightness; }
-    const std::array<uint8_t, X_MAX>& getDisplayBuffer() const { return displayBuffer; }
+    const Framebuffer& getDisplayBuffer() const { return displayBuffer; }
     int getScrollOffset() const { return scrollOffset; }
     Scrolling getScrollDirection() const { return scrollDirection; }
     size_t getRenderedTextSize() const { return renderedTextSize; }
     
+    using Display::prepare;
+
     void simulateDisplayCycle(int n = 1) {
         for (int i = 0; i < n; i++) {
             bool hasChanges = prepare();
@@ -101,7 +109,7 @@ TEST_CASE("Display text functionality", "[display]") {
         // Buffer should contain rendered text
         const auto& buffer = display.getDisplayBuffer();
         bool hasContent = false;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer[i] != 0) {
                 hasContent = true;
                 break;
@@ -118,7 +126,7 @@ TEST_CASE("Display text functionality", "[display]") {
         // Buffer should contain rendered time
         const auto& buffer = display.getDisplayBuffer();
         bool hasContent = false;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer[i] != 0) {
                 hasContent = true;
                 break;
@@ -134,7 +142,7 @@ TEST_CASE("Display text functionality", "[display]") {
         // Buffer should contain both time and text
         const auto& buffer = display.getDisplayBuffer();
         bool hasContent = false;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer[i] != 0) {
                 hasContent = true;
                 break;
@@ -169,7 +177,7 @@ TEST_CASE("Display alignment functionality", "[display]") {
         // Find where content starts (should not be at position 0 for centered short text)
         bool foundContent = false;
         size_t contentStart = 0;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer[i] != 0) {
                 contentStart = i;
                 foundContent = true;
@@ -179,6 +187,25 @@ TEST_CASE("Display alignment functionality", "[display]") {
         REQUIRE(foundContent);
         REQUIRE(contentStart > 0); // Should be offset from start for centering
     }
+
+    SECTION("Left aligned time") {
+        display.setAlignment(Alignment::LEFT);
+        display.setTransition(transition::Type::NONE);
+        display.setScrolling(Scrolling::ENABLED);
+
+        // A time that fits stays at the left edge
+        display.show(std::nullopt, "Clock");
+        display.simulateDisplayCycle(static_cast<int>(ceil(REFRESH_RATE * SCROLL_DELAY)) + 2);
+        auto expected = font::renderString("Clock");
+        expected.resize(WIDTH, 0);
+        REQUIRE(display.getDisplayBuffer() == expected);
+        REQUIRE(display.getScrollOffset() == 0);
+
+        // One wider than the display still scrolls
+        display.show(std::nullopt, "Very long time format that is wider than the display");
+        display.simulateDisplayCycle(static_cast<int>(ceil(REFRESH_RATE * SCROLL_DELAY)) + 2);
+        REQUIRE(display.getScrollOffset() > 0);
+    }
 }
 
 TEST_CASE("Display scrolling functionality", "[display]") {
@@ -200,7 +227,7 @@ TEST_CASE("Display scrolling functionality", "[display]") {
         // First set some scroll state
         display.setTransition(transition::Type::NONE);
         display.show("Very long text that should definitely scroll because it exceeds display width", std::nullopt);
-        REQUIRE(display.getRenderedTextSize() > X_MAX);
+        REQUIRE(display.getRenderedTextSize() > WIDTH);
         display.simulateDisplayCycle();
 
         display.setScrolling(Scrolling::ENABLED);
@@ -218,6 +245,71 @@ TEST_CASE("Display scrolling functionality", "[display]") {
     }
 }
 
+TEST_CASE("Display scrolls one column per frame", "[display]") {
+    TestDisplayImpl display;
+    const std::string text = "Very long text that should definitely scroll because it exceeds display width";
+    const auto rendered = font::renderString(text);
+
+    display.show(text, std::nullopt);
+    display.simulateDisplayCycle(static_cast<int>(ceil(REFRESH_RATE * SCROLL_DELAY)) + 1);
+
+    auto window = [&](size_t offset) {
+        return Framebuffer(rendered.begin() + static_cast<std::ptrdiff_t>(offset),
+                           rendered.begin() + static_cast<std::ptrdiff_t>(offset + WIDTH));
+    };
+
+    size_t offset = static_cast<size_t>(display.getScrollOffset());
+    REQUIRE(offset == 1);
+    REQUIRE(display.getDisplayBuffer() == window(offset));
+
+    // Stops with the end of the text at the right edge
+    while (offset + WIDTH < rendered.size()) {
+        display.simulateDisplayCycle();
+        REQUIRE(static_cast<size_t>(display.getScrollOffset()) == ++offset);
+        REQUIRE(display.getDisplayBuffer() == window(offset));
+    }
+    display.simulateDisplayCycle();
+    REQUIRE(static_cast<size_t>(display.getScrollOffset()) == offset);
+}
+
+TEST_CASE("Display scroll speed is independent of the frame rate", "[display]") {
+    const std::string text = "Very long text that should definitely scroll because it exceeds display width";
+
+    auto scrolledAfter = [&](double seconds, int hz, double speed) {
+        TestDisplayImpl display;
+        display.setScrollSpeed(speed);
+        display.show(text, std::nullopt);
+        display.prepare(SCROLL_DELAY);
+
+        const auto frames = static_cast<int>(std::lround(seconds * hz));
+        for (int i = 0; i < frames; ++i) {
+            display.prepare(1.0 / hz);
+        }
+        return display.getScrollOffset();
+    };
+
+    REQUIRE(scrolledAfter(1.0, 15, SCROLL_SPEED) == static_cast<int>(SCROLL_SPEED));
+    REQUIRE(scrolledAfter(1.0, 30, SCROLL_SPEED) == static_cast<int>(SCROLL_SPEED));
+    REQUIRE(scrolledAfter(1.0, 60, SCROLL_SPEED) == static_cast<int>(SCROLL_SPEED));
+    REQUIRE(scrolledAfter(1.0, 60, 40.0) == 40);
+
+    // Only moves once a whole column has passed
+    REQUIRE(scrolledAfter(0.0, 60, 30.0) == 0);
+    REQUIRE(scrolledAfter(1.0 / 30, 60, 30.0) == 1);
+}
+
+TEST_CASE("Display refresh rate is limited", "[display]") {
+    TestDisplayImpl display;
+    REQUIRE(display.getRefreshRate() == REFRESH_RATE);
+
+    display.setRefreshRate(60);
+    REQUIRE(display.getRefreshRate() == 60);
+    display.setRefreshRate(1000);
+    REQUIRE(display.getRefreshRate() == MAX_REFRESH_RATE);
+    display.setRefreshRate(0);
+    REQUIRE(display.getRefreshRate() == 1);
+}
+
 TEST_CASE("Display state callback functionality", "[display]") {
     std::string callback_text;
     std::string callback_time_format;
@@ -267,7 +359,7 @@ TEST_CASE("Display edge cases", "[display]") {
         display.show("", std::nullopt);
         display.simulateDisplayCycle(); // Simulate display update cycle
         // Should handle empty text gracefully
-        REQUIRE(display.getRenderedTextSize() == 0); // Buffer size should still be X_MAX
+        REQUIRE(display.getRenderedTextSize() == 0); // Buffer size should still be WIDTH
     }
     
     SECTION("Null optional values") {
@@ -283,7 +375,7 @@ TEST_CASE("Display edge cases", "[display]") {
         // Empty time format should use default
         const auto& buffer = display.getDisplayBuffer();
         bool hasContent = false;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer[i] != 0) {
                 hasContent = true;
                 break;
@@ -303,7 +395,7 @@ TEST_CASE("Display edge cases", "[display]") {
         // Buffer should be filled
         const auto& buffer = display.getDisplayBuffer();
         bool hasContent = false;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer[i] != 0) {
                 hasContent = true;
                 break;
@@ -384,7 +476,7 @@ TEST_CASE("Display buffer consistency", "[display]") {
         
         // Buffers should be different for different content
         bool different = false;
-        for (size_t i = 0; i < X_MAX; i++) {
+        for (size_t i = 0; i < WIDTH; i++) {
             if (buffer1[i] != buffer2[i]) {
                 different = true;
                 break;
@@ -393,3 +485,71 @@ TEST_CASE("Display buffer consistency", "[display]") {
         REQUIRE(different);
     }
 }
+
+TEST_CASE("Display adaptive frame clock", "[display][timing]") {
+    using namespace std::chrono_literals;
+    TestDisplayImpl display;
+
+    SECTION("Static text idles after the first frame") {
+        display.show("Idle", std::nullopt);
+        display.start();
+        std::this_thread::sleep_for(300ms);
+        display.stop();
+
+        auto stats = display.getFrameStats();
+        REQUIRE(stats.content_wakeups >= 1);
+        REQUIRE(stats.animation_wakeups <= 1);
+        REQUIRE(stats.clock_wakeups == 0);
+    }
+
+    SECTION("Time display wakes once per second") {
+        display.show(std::nullopt, "%H:%M:%S");
+        display.start();
+        std::this_thread::sleep_for(1100ms);
+        display.stop();
+
+        auto stats = display.getFrameStats();
+        REQUIRE(stats.clock_wakeups >= 1);
+        REQUIRE(stats.clock_wakeups <= 2);
+        REQUIRE(stats.animation_wakeups <= 1);
+    }
+
+    SECTION("Scrolling text runs at full rate") {
+        display.setScrolling(Scrolling::ENABLED);
+        display.show("Very long text that should definitely scroll because it exceeds display width", std::nullopt);
+        display.start();
+        std::this_thread::sleep_for(500ms);
+        display.stop();
+
+        REQUIRE(display.getFrameStats().animation_wakeups >= REFRESH_RATE / 4);
+    }
+
+    SECTION("Animations run at the configured refresh rate within budget") {
+        display.setRefreshRate(MAX_REFRESH_RATE);
+        display.setScrolling(Scrolling::ENABLED);
+        display.show("Very long text that should definitely scroll because it exceeds display width", std::nullopt);
+        display.start();
+        std::this_thread::sleep_for(500ms);
+        display.stop();
+
+        auto stats = display.getFrameStats();
+        REQUIRE(stats.animation_wakeups >= MAX_REFRESH_RATE / 4);
+        REQUIRE(stats.frames >= stats.animation_wakeups);
+        REQUIRE(stats.worst_frame_time > 0ns);
+        REQUIRE(stats.frames_over_budget <= stats.frames / 10);
+    }
+
+    SECTION("Content changes wake an idle display") {
+        display.show("First", std::nullopt);
+        display.start();
+        std::this_thread::sleep_for(100ms);
+        auto updates = display.getUpdateCount();
+
+        display.show("Second", std::nullopt);
+        std::this_thread::sleep_for(100ms);
+        display.stop();
+
+        REQUIRE(display.getUpdateCount() > updates);
+        REQUIRE(display.getFrameStats().content_wakeups >= 2);
+    }
+}
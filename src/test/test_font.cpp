@@ -1,19 +1,22 @@
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <catch2/catch_all.hpp>
 
 #include "utf8_converter.hpp"
 #include "font.hpp"
+#include "font_generated.hpp"
 
 #define CATCH_CONFIG_MAIN
 
 std::string to_hex_string(const std::string& str);
-void test_utf8_conversion(const std::string& utf8_input, const std::string& expected_latin1);
+void test_glyph_conversion(const std::string& utf8_input, const std::string& expected_glyphs);
 
 std::string to_hex_string(const std::string& str) {
     std::string hex_str;
@@ -25,18 +28,18 @@ std::string to_hex_string(const std::string& str) {
     return hex_str;
 }
 
-void test_utf8_conversion(const std::string& utf8_input, const std::string& expected_latin1) {
-    std::string actual = utf8::toLatin1(utf8_input);
-    INFO("Expected: " << to_hex_string(expected_latin1));
+void test_glyph_conversion(const std::string& utf8_input, const std::string& expected_glyphs) {
+    std::string actual = font::toGlyphs(utf8_input);
+    INFO("Expected: " << to_hex_string(expected_glyphs));
     INFO("Actual:   " << to_hex_string(actual));
-    REQUIRE(actual == expected_latin1);
+    REQUIRE(actual == expected_glyphs);
 }
 
-TEST_CASE("UTF-8 to iso8859-1 conversion", "[utf8]") {
-    test_utf8_conversion("Hello, World!", "Hello, World!");
-    test_utf8_conversion("\xc3\x86\xc3\x98\xc3\x85", "\xc6\xd8\xc5");
-    test_utf8_conversion("Café", "Caf\xe9");
-    test_utf8_conversion("\xc2\xb0\xc2\xba", "\xb0\xba");
+TEST_CASE("UTF-8 to glyph conversion", "[utf8]") {
+    test_glyph_conversion("Hello, World!", "Hello, World!");
+    test_glyph_conversion("\xc3\x86\xc3\x98\xc3\x85", "\xc6\xd8\xc5");
+    test_glyph_conversion("Café", "Cafe");  // the font has no glyph for é
+    test_glyph_conversion("\xc2\xb0\xc2\xba", "\xb0\xba");
 }
 
 TEST_CASE("Character mapping functionality", "[font]") {
@@ -61,8 +64,147 @@ TEST_CASE("Character mapping functionality", "[font]") {
 }
 
 TEST_CASE("Composite character", "[font]") {
-    test_utf8_conversion("\xc3\x9f", "\xdf");
-    test_utf8_conversion("\uFB01", "fi");
-    test_utf8_conversion("A\u2103", "A?");
-    test_utf8_conversion("\u0142", "?");
+    test_glyph_conversion("\xc3\x9f", "ss");
+    test_glyph_conversion("\uFB01", "fi");
+    test_glyph_conversion("A\u2103", "A\xb0" "C");
+    test_glyph_conversion("\u0142", "l");
+    test_glyph_conversion("\u4e2d", "?");
+}
+
+TEST_CASE("UTF-8 decoding", "[utf8]") {
+    const std::string text = "A\xc3\xa6\xe2\x86\x92\xf0\x9f\x98\x80";
+    size_t pos = 0;
+    REQUIRE(utf8::decode(text, pos) == U'A');
+    REQUIRE(utf8::decode(text, pos) == U'\u00e6');
+    REQUIRE(utf8::decode(text, pos) == U'\u2192');
+    REQUIRE(utf8::decode(text, pos) == U'\U0001F600');
+    REQUIRE(pos == text.size());
+
+    std::string encoded;
+    for (char32_t code_point : {U'A', U'\u00e6', U'\u2192', U'\U0001F600'}) {
+        utf8::encode(code_point, encoded);
+    }
+    REQUIRE(encoded == text);
+
+    // Malformed input decodes as one replacement per byte skipped
+    for (const std::string malformed : {"\x80", "\xc3", "\xc0\xaf", "\xed\xa0\x80", "\xff"}) {
+        pos = 0;
+        REQUIRE(utf8::decode(malformed, pos) == utf8::REPLACEMENT_CHARACTER);
+        REQUIRE(pos == 1);
+    }
+    REQUIRE(font::toGlyphs("a\xe9" "b") == "a?b");
+}
+
+TEST_CASE("Text decodes straight to glyph indices", "[font]") {
+    // Glyphs the font has are kept, the rest is transliterated
+    REQUIRE(font::toGlyphs("Hello, World!") == "Hello, World!");
+    REQUIRE(font::toGlyphs("\xc3\xa6\xc3\xb8\xc3\xa5 \xc2\xb0") == "\xe6\xf8\xe5 \xb0");
+    REQUIRE(font::toGlyphs("Caf\xc3\xa9 Stra\xc3\x9f" "e") == "Cafe Strasse");
+    REQUIRE(font::toGlyphs("21\u2103 \u201cok\u201d \u2026") == "21\xb0" "C \"ok\" ...");
+    REQUIRE(font::toGlyphs("a\tb\x7f" "c") == "a b c");
+    REQUIRE(font::toGlyphs("\u4e2d") == "?");
+
+    // Glyphs beyond Latin-1 have an index of their own
+    for (const auto& extra : font::extraGlyphs) {
+        std::string utf8;
+        utf8::encode(extra.code_point, utf8);
+        const std::string glyphs = font::toGlyphs(utf8);
+        REQUIRE(glyphs == std::string(1, static_cast<char>(extra.index)));
+        REQUIRE(font::getGlyph(glyphs[0]).defined);
+        REQUIRE(font::renderString(glyphs) != font::renderString(" "));
+        REQUIRE(font::fromGlyphs(glyphs) == utf8);
+    }
+
+    const std::string mixed = "\xe2\x86\x90 12\xc2\xb0 \xe2\x98\x80 \xc3\xa6";
+    REQUIRE(font::fromGlyphs(font::toGlyphs(mixed)) == mixed);
+}
+
+TEST_CASE("Lazy text renders the same columns as the whole string", "[font]") {
+    std::string text;
+    for (int i = 0; i < 20; ++i) {
+        text += "The quick brown fox jumps over the lazy dog, " + std::to_string(i) + "\xe6\xf8\xe5 ";
+    }
+    const auto rendered = font::renderString(text);
+    const font::LazyText lazy(text);
+
+    REQUIRE(lazy.width() == rendered.size());
+    REQUIRE(font::LazyText().empty());
+
+    for (size_t first = 0; first < rendered.size() + 10; first += 7) {
+        for (size_t count : {size_t{1}, size_t{5}, size_t{128}}) {
+            std::vector<uint8_t> window(count, 0xAA);
+            lazy.render(first, count, window.data());
+
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t expected = first + i < rendered.size() ? rendered[first + i] : 0;
+                REQUIRE(window[i] == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Font atlas covers every character", "[font]") {
+    // Characters without a glyph render as a space
+    REQUIRE(font::renderString("\x01") == font::renderString(" "));
+    REQUIRE(font::stringWidth("Hello World") == font::renderString("Hello World").size());
+
+    for (int c = 0; c < 256; ++c) {
+        const auto rendered = font::renderString(std::string(1, static_cast<char>(c)));
+        REQUIRE_FALSE(rendered.empty());
+        REQUIRE(rendered.back() == 0);
+        REQUIRE(rendered.size() == font::getGlyph(static_cast<char>(c)).advance);
+    }
+}
+
+TEST_CASE("Font rendering benchmark", "[.][benchmark]") {
+    const std::string time = "Wednesday, Oct 16 12:34:56";
+    std::string ticker;
+    for (int i = 0; i < 100; ++i) {
+        ticker += "The quick brown fox jumps over the lazy dog. ";
+    }
+
+    BENCHMARK("renderString time (" + std::to_string(time.size()) + " characters)") {
+        return font::renderString(time);
+    };
+
+    BENCHMARK("renderString ticker (" + std::to_string(ticker.size()) + " characters)") {
+        return font::renderString(ticker);
+    };
+}
+
+TEST_CASE("Font rendering is safe to use from several threads", "[font][stress]") {
+    std::atomic<bool> failed{false};
+    std::vector<std::thread> threads;
+
+    // Rotating time strings, like the frame timer thread renders them
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&failed, t] {
+            for (int i = 0; i < 5000; ++i) {
+                char time[16];
+                snprintf(time, sizeof(time), "%02d:%02d:%02d", t, (i / 60) % 60, i % 60);
+                const std::string text = time;
+                if (font::renderString(text).size() != font::stringWidth(text)) {
+                    failed = true;
+                }
+            }
+        });
+    }
+
+    // Texts arriving over MQTT, laid out lazily and compared with the whole rendering
+    threads.emplace_back([&failed] {
+        for (int i = 0; i < 2000; ++i) {
+            const std::string text = "Message " + std::to_string(i % 150);
+            const font::LazyText lazy(text);
+            std::vector<uint8_t> columns(lazy.width());
+            lazy.render(0, columns.size(), columns.data());
+            if (columns != font::renderString(text)) {
+                failed = true;
+            }
+        }
+    });
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE_FALSE(failed);
 }
@@ -0,0 +1,129 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "frame_output.hpp"
+
+using namespace std::chrono_literals;
+using namespace ht1632;
+
+namespace {
+
+Frame frameWith(uint8_t value)
+{
+    return Frame(128, value);
+}
+
+template <typename Predicate>
+bool waitFor(Predicate predicate, std::chrono::milliseconds timeout = 1000ms)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Frame mailbox keeps the newest frame", "[output]") {
+    FrameMailbox<Frame> mailbox;
+
+    SECTION("Nothing to take before a frame is published") {
+        REQUIRE(mailbox.take() == nullptr);
+    }
+
+    SECTION("Each frame is taken once") {
+        REQUIRE_FALSE(mailbox.publish(frameWith(1)));
+        auto frame = mailbox.take();
+        REQUIRE(frame != nullptr);
+        REQUIRE((*frame)[0] == 1);
+        REQUIRE(mailbox.take() == nullptr);
+    }
+
+    SECTION("Newest frame wins") {
+        REQUIRE_FALSE(mailbox.publish(frameWith(1)));
+        REQUIRE(mailbox.publish(frameWith(2)));
+        REQUIRE(mailbox.publish(frameWith(3)));
+
+        auto frame = mailbox.take();
+        REQUIRE(frame != nullptr);
+        REQUIRE((*frame).back() == 3);
+        REQUIRE(mailbox.take() == nullptr);
+    }
+
+    SECTION("Taken frame stays intact while new ones are published") {
+        mailbox.publish(frameWith(1));
+        auto frame = mailbox.take();
+        mailbox.publish(frameWith(2));
+        mailbox.publish(frameWith(3));
+        REQUIRE((*frame)[0] == 1);
+    }
+}
+
+TEST_CASE("Frame output writes from its own thread", "[output]") {
+    std::mutex mutex;
+    std::vector<uint8_t> written;
+    std::thread::id writer;
+
+    FrameOutput output([&](const Frame& frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        written.push_back(frame[0]);
+        writer = std::this_thread::get_id();
+    });
+
+    output.submit(frameWith(7));
+    REQUIRE(waitFor([&] { return output.getStats().frames_written == 1; }));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    REQUIRE(written == std::vector<uint8_t>{7});
+    REQUIRE(writer != std::this_thread::get_id());
+}
+
+TEST_CASE("Frame output drops stale frames behind a slow bus", "[output]") {
+    std::atomic<int> last{-1};
+    std::atomic<bool> release{false};
+
+    FrameOutput output([&](const Frame& frame) {
+        while (!release.load()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        last = frame[0];
+    });
+
+    // The first frame blocks the bus, submitting must not wait for it
+    auto start = std::chrono::steady_clock::now();
+    for (uint8_t i = 0; i < 50; ++i) {
+        output.submit(frameWith(i));
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < 50ms);
+
+    release = true;
+    REQUIRE(waitFor([&] { return last.load() == 49; }));
+
+    auto stats = output.getStats();
+    REQUIRE(stats.frames_submitted == 50);
+    REQUIRE(stats.frames_written + stats.frames_dropped == 50);
+    REQUIRE(stats.frames_dropped > 0);
+    REQUIRE(stats.worst_latency >= stats.average_latency);
+    REQUIRE(stats.worst_latency > 0ns);
+}
+
+TEST_CASE("Frame output stops while idle", "[output]") {
+    std::atomic<int> writes{0};
+    FrameOutput output([&](const Frame&) { writes++; });
+
+    std::this_thread::sleep_for(10ms);
+    output.stop();
+    output.submit(frameWith(1));
+    std::this_thread::sleep_for(10ms);
+
+    REQUIRE(writes.load() == 0);
+}
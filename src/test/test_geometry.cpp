@@ -0,0 +1,145 @@
+#include <cstdlib>
+
+#include <catch2/catch_all.hpp>
+
+#include "geometry.hpp"
+
+using namespace display;
+
+TEST_CASE("Geometry maps panels to framebuffer columns", "[geometry]") {
+    Geometry geometry(4, 32);
+    REQUIRE(geometry.width() == 128);
+    REQUIRE(geometry.validate().empty());
+
+    SECTION("Chain order") {
+        REQUIRE(geometry.firstColumnOf(0) == 0);
+        REQUIRE(geometry.firstColumnOf(3) == 96);
+    }
+
+    SECTION("Upside down") {
+        geometry.flip = true;
+        REQUIRE(geometry.firstColumnOf(0) == 96);
+        REQUIRE(geometry.firstColumnOf(3) == 0);
+    }
+
+    SECTION("Panel order") {
+        geometry.panel_order = {2, 3, 0, 1};
+        REQUIRE(geometry.firstColumnOf(0) == 64);
+        REQUIRE(geometry.firstColumnOf(2) == 0);
+        geometry.flip = true;
+        REQUIRE(geometry.firstColumnOf(0) == 32);
+    }
+}
+
+TEST_CASE("Geometry validation", "[geometry]") {
+    Geometry geometry(16, 24);
+    REQUIRE(geometry.validate().empty());
+
+    SECTION("Unsupported width") {
+        geometry.panel_width = 20;
+        REQUIRE_FALSE(geometry.validate().empty());
+    }
+
+    SECTION("Chip select per panel") {
+        geometry.cs_pins = {1, 2, 3};
+        REQUIRE_FALSE(geometry.validate().empty());
+    }
+
+    SECTION("Order lists every panel once") {
+        geometry.panel_count = 3;
+        geometry.panel_order = {0, 1, 1};
+        REQUIRE_FALSE(geometry.validate().empty());
+        geometry.panel_order = {0, 1};
+        REQUIRE_FALSE(geometry.validate().empty());
+        geometry.panel_order = {2, 0, 1};
+        REQUIRE(geometry.validate().empty());
+    }
+}
+
+TEST_CASE("Geometry chains", "[geometry]") {
+    Geometry geometry(8, 32);
+    REQUIRE(geometry.chainCount() == 1);
+    REQUIRE(geometry.panelsIn(0) == 8);
+
+    geometry.chains = {3, 5};
+    REQUIRE(geometry.validate().empty());
+    REQUIRE(geometry.chainCount() == 2);
+    REQUIRE(geometry.firstPanelOf(1) == 3);
+    REQUIRE(geometry.panelsIn(1) == 5);
+
+    geometry.chains = {3, 4};
+    REQUIRE_FALSE(geometry.validate().empty());
+    geometry.chains = {8, 0};
+    REQUIRE_FALSE(geometry.validate().empty());
+}
+
+TEST_CASE("Geometry from the environment", "[geometry]") {
+    const char* names[] = {"DISPLAY_PANELS", "DISPLAY_PANEL_WIDTH", "DISPLAY_CS_PINS", "DISPLAY_FLIP", "DISPLAY_PANEL_ORDER", "DISPLAY_CHAINS"};
+    for (const char* name : names) {
+        unsetenv(name);
+    }
+
+    SECTION("Defaults") {
+        auto geometry = Geometry::fromEnvironment();
+        REQUIRE(geometry);
+        REQUIRE(geometry->panel_count == DEFAULT_PANEL_COUNT);
+        REQUIRE(geometry->panel_width == DEFAULT_PANEL_WIDTH);
+        REQUIRE(geometry->cs_pins.empty());
+    }
+
+    SECTION("Eight panel wall") {
+        setenv("DISPLAY_PANELS", "8", 1);
+        setenv("DISPLAY_CS_PINS", "8,9,15,16,0,1,2,3", 1);
+        setenv("DISPLAY_FLIP", "false", 1);
+        setenv("DISPLAY_PANEL_ORDER", "7,6,5,4,3,2,1,0", 1);
+        setenv("DISPLAY_CHAINS", "4,4", 1);
+
+        auto geometry = Geometry::fromEnvironment();
+        REQUIRE(geometry);
+        REQUIRE(geometry->width() == 8 * DEFAULT_PANEL_WIDTH);
+        REQUIRE(geometry->cs_pins == std::vector<int>{8, 9, 15, 16, 0, 1, 2, 3});
+        REQUIRE_FALSE(geometry->flip);
+        REQUIRE(geometry->firstColumnOf(0) == 7 * DEFAULT_PANEL_WIDTH);
+        REQUIRE(geometry->chainCount() == 2);
+    }
+
+    SECTION("Malformed values") {
+        setenv("DISPLAY_CS_PINS", "8,x", 1);
+        REQUIRE_FALSE(Geometry::fromEnvironment());
+        unsetenv("DISPLAY_CS_PINS");
+
+        setenv("DISPLAY_PANELS", "0", 1);
+        REQUIRE_FALSE(Geometry::fromEnvironment());
+        unsetenv("DISPLAY_PANELS");
+
+        // Anything but true or false would otherwise silently mean not flipped
+        for (const char* value : {"1", "yes", "TRUE", "ture", ""}) {
+            setenv("DISPLAY_FLIP", value, 1);
+            INFO(value);
+            REQUIRE_FALSE(Geometry::fromEnvironment());
+        }
+    }
+
+    for (const char* name : names) {
+        unsetenv(name);
+    }
+}
+
+TEST_CASE("Refresh rate from the environment", "[geometry]") {
+    unsetenv("DISPLAY_REFRESH_RATE");
+    REQUIRE(refreshRateFromEnvironment(15, 60) == 15);
+
+    setenv("DISPLAY_REFRESH_RATE", "30", 1);
+    REQUIRE(refreshRateFromEnvironment(15, 60) == 30);
+    setenv("DISPLAY_REFRESH_RATE", "60", 1);
+    REQUIRE(refreshRateFromEnvironment(15, 60) == 60);
+
+    // Rejected rather than clamped
+    for (const char* value : {"6O", "fast", "", "0", "-5", "61"}) {
+        setenv("DISPLAY_REFRESH_RATE", value, 1);
+        INFO(value);
+        REQUIRE_FALSE(refreshRateFromEnvironment(15, 60));
+    }
+
+    unsetenv("DISPLAY_REFRESH_RATE");
+}
@@ -0,0 +1,351 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "ht1632_driver.hpp"
+#include "loopback_transport.hpp"
+
+using namespace ht1632;
+
+namespace {
+
+constexpr size_t PANEL_COUNT = 4;
+constexpr size_t PANEL_WIDTH = 32;
+constexpr size_t WIDTH = PANEL_COUNT * PANEL_WIDTH;
+
+Frame randomFrame(uint32_t seed, size_t width = WIDTH)
+{
+    Frame frame(width);
+    for (auto& column : frame) {
+        seed = seed * 1664525U + 1013904223U;
+        column = static_cast<uint8_t>(seed >> 24);
+    }
+    return frame;
+}
+
+// Panel RAM must hold exactly what the frame shows
+void requireShown(const LoopbackTransport& loopback, const Frame& frame, const display::Geometry& geometry)
+{
+    for (size_t panel = 0; panel < geometry.panel_count; ++panel) {
+        const size_t block = geometry.panel_order.empty() ? panel : geometry.panel_order[panel];
+
+        PanelColumns expected{};
+        for (size_t col = 0; col < geometry.panel_width; ++col) {
+            // Upside down the panel shows the mirrored columns, top row first on the wire either way
+            const size_t x = block * geometry.panel_width + col;
+            expected[col] = geometry.flip ? frame[frame.size() - 1 - x] : REVERSE_BITS[frame[x]];
+        }
+        REQUIRE(loopback.panel(panel).columns() == expected);
+    }
+}
+
+void requireShown(const LoopbackTransport& loopback, const Frame& frame, bool flip)
+{
+    requireShown(loopback, frame, display::Geometry(PANEL_COUNT, PANEL_WIDTH, flip));
+}
+
+} // namespace
+
+TEST_CASE("Loopback transport decodes commands", "[driver]") {
+    LoopbackTransport loopback(PANEL_COUNT);
+    Driver driver(loopback, display::Geometry(PANEL_COUNT, PANEL_WIDTH, true));
+
+    SECTION("Command bit stream") {
+        driver.sendCommand(1, HT1632_CMD_LED_ON);
+
+        // 100 + command + don't-care bit, padded to two bytes
+        const std::vector<bool> expected = {1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0};
+        REQUIRE(loopback.bits() == expected);
+        REQUIRE(loopback.panel(1).leds_on);
+        REQUIRE_FALSE(loopback.panel(0).leds_on);
+    }
+
+    SECTION("Initialization reaches every panel") {
+        driver.initialize();
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 9);
+
+        for (size_t panel = 0; panel < PANEL_COUNT; ++panel) {
+            const auto& state = loopback.panel(panel);
+            REQUIRE(state.system_enabled);
+            REQUIRE(state.leds_on);
+            REQUIRE_FALSE(state.blinking);
+            REQUIRE(state.com == HT1632_CMD_COM);
+            REQUIRE(state.pwm == 9);
+            REQUIRE(state.commands == 5);
+        }
+    }
+}
+
+TEST_CASE("Driver follows the display geometry", "[driver]") {
+    const bool flip = GENERATE(true, false);
+    const size_t panel_width = GENERATE(size_t{8}, size_t{16}, size_t{24}, size_t{32});
+
+    display::Geometry geometry(8, panel_width, flip);
+    geometry.panel_order = {1, 0, 3, 2, 5, 4, 7, 6};
+
+    LoopbackTransport loopback(geometry.panel_count);
+    Driver driver(loopback, geometry);
+
+    for (uint32_t seed = 1; seed < 4; ++seed) {
+        auto frame = randomFrame(seed, geometry.width());
+        driver.writeFrame(frame);
+        requireShown(loopback, frame, geometry);
+    }
+
+    SECTION("Frames of another width are dropped") {
+        const auto sent = loopback.getBytesSent();
+        driver.writeFrame(randomFrame(9, geometry.width() + 1));
+        REQUIRE(loopback.getBytesSent() == sent);
+    }
+}
+
+TEST_CASE("Driver drops commands already in effect", "[driver]") {
+    LoopbackTransport loopback(PANEL_COUNT);
+    Driver driver(loopback, display::Geometry(PANEL_COUNT, PANEL_WIDTH, false));
+    driver.initialize();
+
+    SECTION("Repeated brightness") {
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 4);
+        const auto sent = loopback.getBytesSent();
+
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 4);
+        driver.sendCommand(1, HT1632_CMD_PWM + 4);
+        REQUIRE(loopback.getBytesSent() == sent);
+        REQUIRE(driver.getTransferStats().commands_suppressed == 2);
+
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 5);
+        REQUIRE(loopback.getBytesSent() > sent);
+        REQUIRE(loopback.panel(0).pwm == 5);
+    }
+
+    SECTION("LED and blink state") {
+        // Set by the initialization
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_LED_ON);
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_BLINK_OFF);
+        REQUIRE(driver.getTransferStats().commands_suppressed == 2);
+
+        driver.sendCommand(2, HT1632_CMD_BLINK_ON);
+        REQUIRE(loopback.panel(2).blinking);
+
+        // Panel 2 differs, so the command still goes to all of them
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_BLINK_OFF);
+        REQUIRE_FALSE(loopback.panel(2).blinking);
+        REQUIRE(driver.getTransferStats().commands_suppressed == 2);
+    }
+
+    SECTION("Other commands are always sent") {
+        const auto commands = loopback.panel(0).commands;
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_COM);
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_COM);
+        REQUIRE(loopback.panel(0).commands == commands + 2);
+    }
+
+    SECTION("Initialization forgets the state") {
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 8);
+        loopback.panel(0).pwm = 0;
+
+        driver.initialize();
+        driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 8);
+        REQUIRE(loopback.panel(0).pwm == 8);
+        REQUIRE(driver.getTransferStats().commands_suppressed == 0);
+    }
+}
+
+TEST_CASE("Driver frames decode to the shown image", "[driver]") {
+    const bool flip = GENERATE(true, false);
+
+    LoopbackTransport loopback(PANEL_COUNT);
+    Driver driver(loopback, display::Geometry(PANEL_COUNT, PANEL_WIDTH, flip));
+
+    SECTION("Full frames") {
+        for (uint32_t seed = 1; seed < 10; ++seed) {
+            auto frame = randomFrame(seed);
+            driver.writeFrame(frame);
+            requireShown(loopback, frame, flip);
+        }
+    }
+
+    SECTION("Small changes use partial writes") {
+        auto frame = randomFrame(3);
+        driver.writeFrame(frame);
+
+        for (size_t i = 0; i < WIDTH; i += 5) {
+            frame[i] = static_cast<uint8_t>(~frame[i]);
+            frame[(i * 7) % WIDTH] ^= 0x18;
+            driver.writeFrame(frame);
+            requireShown(loopback, frame, flip);
+        }
+
+        auto stats = driver.getTransferStats();
+        REQUIRE(stats.panels_partial > 0);
+        REQUIRE(stats.bytes_written == loopback.getBytesSent());
+    }
+
+    SECTION("Unchanged frames send nothing") {
+        auto frame = randomFrame(4);
+        driver.writeFrame(frame);
+        const auto sent = loopback.getBytesSent();
+        const auto selects = loopback.getSelectCount();
+
+        driver.writeFrame(frame);
+
+        REQUIRE(loopback.getBytesSent() == sent);
+        REQUIRE(loopback.getSelectCount() == selects);
+        REQUIRE(driver.getTransferStats().panels_skipped == PANEL_COUNT);
+    }
+
+    SECTION("Initialization forces a full rewrite") {
+        auto frame = randomFrame(5);
+        driver.writeFrame(frame);
+        driver.initialize();
+        driver.writeFrame(frame);
+
+        auto stats = driver.getTransferStats();
+        REQUIRE(stats.panels_written == 2 * PANEL_COUNT);
+        REQUIRE(stats.panels_partial == 0);
+    }
+}
+
+namespace {
+
+// Transport that can only write, like the reference wiring without RD
+class WriteOnlyTransport : public Transport
+{
+public:
+    void select(int, uint16_t) override {}
+    void write(const void*, size_t, uint16_t) override {}
+};
+
+// Transport that reads, but with nothing driving MISO the line stays at its pull
+class UnconnectedTransport : public WriteOnlyTransport
+{
+public:
+    explicit UnconnectedTransport(uint8_t level) : m_level(level) {}
+
+    bool read(const void*, void* response, size_t size) override
+    {
+        auto* out = static_cast<uint8_t*>(response);
+        std::fill(out, out + size, m_level);
+        return true;
+    }
+
+private:
+    uint8_t m_level;
+};
+
+} // namespace
+
+TEST_CASE("Driver readback verification", "[driver]") {
+    LoopbackTransport loopback(PANEL_COUNT);
+    Driver driver(loopback, display::Geometry(PANEL_COUNT, PANEL_WIDTH, false));
+
+    driver.initialize();
+    driver.sendCommand(HT1632_PANEL_ALL, HT1632_CMD_PWM + 7);
+    auto frame = randomFrame(11);
+    driver.writeFrame(frame);
+
+    SECTION("Intact panels are left alone") {
+        const auto sent = loopback.getBytesSent();
+        for (size_t i = 0; i < 2 * PANEL_COUNT; ++i) {
+            REQUIRE(driver.verifyNextPanel());
+        }
+
+        auto health = driver.getHealthStats();
+        REQUIRE(health.panels_verified == 2 * PANEL_COUNT);
+        REQUIRE(health.corruptions_detected == 0);
+        REQUIRE(health.panels_repaired == 0);
+
+        // Only the read requests went out
+        REQUIRE(loopback.getBytesSent() == sent + 2 * PANEL_COUNT * WRITE_BUFFER_SIZE);
+    }
+
+    SECTION("A corrupted panel is reinitialized and rewritten on its own") {
+        const size_t broken = PANEL_COUNT - 1;
+        loopback.panel(broken).ram[5] ^= 0xF;
+        loopback.panel(broken).leds_on = false;
+        loopback.panel(broken).pwm = 15;
+
+        std::vector<uint64_t> commands;
+        for (size_t panel = 0; panel < PANEL_COUNT; ++panel) {
+            commands.push_back(loopback.panel(panel).commands);
+        }
+
+        for (size_t i = 0; i < PANEL_COUNT; ++i) {
+            REQUIRE(driver.verifyNextPanel());
+        }
+
+        auto health = driver.getHealthStats();
+        REQUIRE(health.panels_verified == PANEL_COUNT);
+        REQUIRE(health.corruptions_detected == 1);
+        REQUIRE(health.panels_repaired == 1);
+
+        requireShown(loopback, frame, false);
+        REQUIRE(loopback.panel(broken).leds_on);
+        REQUIRE(loopback.panel(broken).pwm == 7);
+        for (size_t panel = 0; panel < broken; ++panel) {
+            REQUIRE(loopback.panel(panel).commands == commands[panel]);
+        }
+    }
+
+    SECTION("Panels not written yet are not checked") {
+        Driver fresh(loopback, display::Geometry(PANEL_COUNT, PANEL_WIDTH, false));
+        REQUIRE(fresh.verifyNextPanel());
+        REQUIRE(fresh.getHealthStats().panels_verified == 0);
+    }
+}
+
+TEST_CASE("Driver reports transports that cannot read", "[driver]") {
+    WriteOnlyTransport transport;
+    Driver driver(transport, display::Geometry(PANEL_COUNT, PANEL_WIDTH, false));
+
+    driver.writeFrame(randomFrame(12));
+    REQUIRE_FALSE(driver.verifyNextPanel());
+    REQUIRE(driver.getHealthStats().panels_verified == 0);
+}
+
+TEST_CASE("Driver reports readback nothing answered", "[driver]") {
+    for (uint8_t level : {uint8_t{0x00}, uint8_t{0xFF}}) {
+        UnconnectedTransport transport(level);
+        Driver driver(transport, display::Geometry(PANEL_COUNT, PANEL_WIDTH, false));
+
+        driver.writeFrame(randomFrame(13));
+        INFO("MISO at " << int{level});
+        REQUIRE_FALSE(driver.verifyNextPanel());
+
+        auto health = driver.getHealthStats();
+        REQUIRE(health.panels_verified == 0);
+        REQUIRE(health.corruptions_detected == 0);
+        REQUIRE(health.panels_repaired == 0);
+    }
+}
+
+TEST_CASE("Driver throughput benchmark", "[.][benchmark]") {
+    LoopbackTransport loopback(PANEL_COUNT);
+    Driver driver(loopback, display::Geometry(PANEL_COUNT, PANEL_WIDTH, true));
+
+    std::vector<Frame> frames;
+    for (uint32_t seed = 0; seed < 64; ++seed) {
+        frames.push_back(randomFrame(seed));
+    }
+
+    BENCHMARK_ADVANCED("full frames through loopback")(Catch::Benchmark::Chronometer meter) {
+        loopback.clear();
+        meter.measure([&](int i) {
+            driver.writeFrame(frames[static_cast<size_t>(i) % frames.size()]);
+            return loopback.getBytesSent();
+        });
+    };
+
+    BENCHMARK_ADVANCED("single column changes through loopback")(Catch::Benchmark::Chronometer meter) {
+        loopback.clear();
+        Frame frame = frames[0];
+        meter.measure([&](int i) {
+            frame[static_cast<size_t>(i) % WIDTH] ^= 0x81;
+            driver.writeFrame(frame);
+            return loopback.getBytesSent();
+        });
+    };
+}
@@ -0,0 +1,381 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <new>
+
+#include <catch2/catch_all.hpp>
+
+#include "ht1632_protocol.hpp"
+
+using namespace ht1632;
+
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size)
+{
+    allocations++;
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+constexpr size_t PANEL_COUNT = 4;
+constexpr size_t PANEL_WIDTH = 32;
+constexpr size_t WIDTH = PANEL_COUNT * PANEL_WIDTH;
+
+bool bitAt(const WriteBuffer& buffer, size_t bit_pos)
+{
+    return (buffer[bit_pos / 8] >> (7 - bit_pos % 8)) & 1U;
+}
+
+uint32_t readBits(const WriteBuffer& buffer, size_t& bit_pos, size_t count)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+        value = (value << 1) | (bitAt(buffer, bit_pos++) ? 1U : 0U);
+    }
+    return value;
+}
+
+// Replays a write against a model of panel RAM, the way the chip would
+void applyWrite(PanelColumns& ram, const WriteBuffer& buffer, size_t size)
+{
+    size_t bit_pos = 0;
+    REQUIRE(readBits(buffer, bit_pos, HT1632_LENGTH_ID) == HT1632_ID_WRITE);
+    size_t address = readBits(buffer, bit_pos, HT1632_LENGTH_ADDR);
+
+    while (bit_pos < size * 8) {
+        auto& column = ram[(address % RAM_NIBBLES) / 2];
+        const size_t top = address % 2 == 0 ? 7 : 3;
+        for (size_t row = 0; row < 4 && bit_pos < size * 8; ++row) {
+            const auto mask = static_cast<uint8_t>(1U << (top - row));
+            column = static_cast<uint8_t>(bitAt(buffer, bit_pos++) ? column | mask : column & ~mask);
+        }
+        address++;
+    }
+}
+
+// Bit-at-a-time packer the table-driven one replaced, kept as reference
+WriteBuffer legacyWriteBuffer(const Frame& displayBuffer, size_t panel, bool flip)
+{
+    WriteBuffer buffer{};
+    size_t bit_pos = HT1632_LENGTH_ID + HT1632_LENGTH_ADDR;
+    buffer[0] = static_cast<uint8_t>(HT1632_ID_WRITE << 5);
+
+    auto packColumn = [&](size_t col, size_t rows) {
+        uint8_t pixels;
+        if (flip) {
+            pixels = REVERSE_BITS[displayBuffer[(PANEL_COUNT - 1 - panel) * PANEL_WIDTH + PANEL_WIDTH - 1 - col]];
+        } else {
+            pixels = displayBuffer[panel * PANEL_WIDTH + col];
+        }
+        for (size_t row = 0; row < rows; ++row) {
+            if (pixels & (1U << row)) {
+                buffer[bit_pos / 8] |= static_cast<uint8_t>(1U << (7 - bit_pos % 8));
+            }
+            bit_pos++;
+        }
+    };
+
+    for (size_t col = 0; col < PANEL_WIDTH; ++col) {
+        packColumn(col, 8);
+    }
+    packColumn(0, 6);
+    return buffer;
+}
+
+Frame randomDisplay(uint32_t seed)
+{
+    Frame displayBuffer(WIDTH);
+    for (auto& column : displayBuffer) {
+        seed = seed * 1664525U + 1013904223U;
+        column = static_cast<uint8_t>(seed >> 24);
+    }
+    return displayBuffer;
+}
+
+PanelColumns pattern(uint8_t seed)
+{
+    PanelColumns columns;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        columns[i] = static_cast<uint8_t>(seed + i * 37);
+    }
+    return columns;
+}
+
+} // namespace
+
+TEST_CASE("HT1632 write planning", "[ht1632]") {
+    auto previous = pattern(1);
+
+    SECTION("Unknown RAM contents need a full write") {
+        auto plan = planWrite(nullptr, previous);
+        REQUIRE(plan.isFull());
+        REQUIRE(plan.address == 0);
+    }
+
+    SECTION("Unchanged columns need no write") {
+        auto plan = planWrite(&previous, previous);
+        REQUIRE(plan.nibbles == 0);
+    }
+
+    SECTION("Single column change writes only that column") {
+        auto next = previous;
+        next[5] ^= 0xFF;
+        auto plan = planWrite(&previous, next);
+        REQUIRE(plan.address == 10);
+        REQUIRE(plan.nibbles == 2);
+
+        next = previous;
+        next[5] ^= 0x01;
+        plan = planWrite(&previous, next);
+        REQUIRE(plan.address == 11);
+        REQUIRE(plan.nibbles == 1);
+    }
+
+    SECTION("Changes at both ends wrap around the RAM") {
+        auto next = previous;
+        next[PANEL_WIDTH - 1] ^= 0xFF;
+        next[0] ^= 0xFF;
+        auto plan = planWrite(&previous, next);
+        REQUIRE(plan.address == RAM_NIBBLES - 2);
+        REQUIRE(plan.nibbles == 4);
+    }
+
+    SECTION("Changes in every column use a full write") {
+        auto next = previous;
+        for (size_t i = 0; i < next.size(); ++i) {
+            next[i] ^= 0x11;
+        }
+        auto plan = planWrite(&previous, next);
+        REQUIRE(plan.isFull());
+        REQUIRE(plan.address == 0);
+    }
+}
+
+TEST_CASE("HT1632 write buffer encoding", "[ht1632]") {
+    SECTION("Full write keeps the legacy layout") {
+        PanelColumns columns{};
+        columns[0] = 0b11111100;
+        columns[1] = 0b00000001;
+
+        WritePlan plan;
+        plan.nibbles = RAM_NIBBLES;
+
+        WriteBuffer buffer;
+        REQUIRE(createWriteBuffer(columns, plan, buffer) == WRITE_BUFFER_SIZE);
+
+        // 101 + address 0, then column 0 rows 0-5 set
+        REQUIRE(buffer[0] == 0xA0);
+        REQUIRE(buffer[1] == 0x3F);
+        // Column 1 row 7 is bit 17 of the data
+        REQUIRE(bitAt(buffer, 10 + 8 + 7));
+        // Padding repeats column 0 rows 0-5
+        REQUIRE(buffer[WRITE_BUFFER_SIZE - 1] == 0x3F);
+    }
+
+    SECTION("Partial writes only touch the planned range") {
+        auto previous = pattern(3);
+        for (size_t changed : {size_t{0}, size_t{7}, size_t{PANEL_WIDTH - 1}}) {
+            auto next = previous;
+            next[changed] = static_cast<uint8_t>(~next[changed]);
+
+            auto plan = planWrite(&previous, next);
+            REQUIRE_FALSE(plan.isFull());
+
+            WriteBuffer buffer;
+            auto size = createWriteBuffer(next, plan, buffer);
+            REQUIRE(size == writeSize(plan.nibbles));
+            REQUIRE(size < WRITE_BUFFER_SIZE);
+
+            auto ram = previous;
+            applyWrite(ram, buffer, size);
+            REQUIRE(ram == next);
+        }
+    }
+
+    SECTION("Any plan reproduces the target RAM") {
+        auto previous = pattern(9);
+        auto next = pattern(200);
+
+        WritePlan full;
+        full.nibbles = RAM_NIBBLES;
+
+        WriteBuffer buffer;
+        auto ram = previous;
+        applyWrite(ram, buffer, createWriteBuffer(next, full, buffer));
+        REQUIRE(ram == next);
+    }
+}
+
+TEST_CASE("HT1632 read buffer encoding", "[ht1632]") {
+    WriteBuffer request;
+    const size_t size = createReadBuffer(request);
+    REQUIRE(size == WRITE_BUFFER_SIZE);
+
+    size_t bit_pos = 0;
+    REQUIRE(readBits(request, bit_pos, HT1632_LENGTH_ID) == HT1632_ID_READ);
+    REQUIRE(readBits(request, bit_pos, HT1632_LENGTH_ADDR) == 0);
+
+    SECTION("Response decodes to the columns in RAM") {
+        // The panel shifts RAM out after the header in the same layout a full write clocks it in
+        auto columns = pattern(77);
+        WritePlan full;
+        full.nibbles = RAM_NIBBLES;
+
+        WriteBuffer response;
+        createWriteBuffer(columns, full, response);
+        REQUIRE(decodeReadResponse(response) == columns);
+    }
+}
+
+TEST_CASE("HT1632 read response from the bus", "[ht1632]") {
+    // Written out by hand from the datasheet's read mode timing: the echoed ID 110 and
+    // address 0000000, then 4 bits per address, lowest address first, for a panel
+    // showing 0x81 in column 0, 0x3C in column 1 and 0xFF in the last column
+    const WriteBuffer captured = {
+        0xC0, 0x20, 0x4F, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3F, 0xC0,
+    };
+
+    PanelColumns expected{};
+    expected[0] = 0x81;
+    expected[1] = 0x3C;
+    expected[RAM_COLUMNS - 1] = 0xFF;
+
+    REQUIRE(isReadResponse(captured));
+    REQUIRE(decodeReadResponse(captured) == expected);
+
+    SECTION("A blank panel still answers") {
+        WriteBuffer blank{};
+        blank[0] = 0xC0;
+        REQUIRE(isReadResponse(blank));
+        REQUIRE(decodeReadResponse(blank) == PanelColumns{});
+    }
+
+    SECTION("An unconnected MISO does not") {
+        WriteBuffer floating;
+        floating.fill(0x00);
+        REQUIRE_FALSE(isReadResponse(floating));
+        floating.fill(0xFF);
+        REQUIRE_FALSE(isReadResponse(floating));
+    }
+}
+
+TEST_CASE("HT1632 table-driven packing matches the bitwise packer", "[ht1632]") {
+    auto displayBuffer = randomDisplay(42);
+
+    for (size_t panel = 0; panel < PANEL_COUNT; ++panel) {
+        WritePlan full;
+        full.nibbles = RAM_NIBBLES;
+
+        PanelColumns columns;
+        WriteBuffer buffer;
+
+        extractPanelColumns<PANEL_WIDTH, true>(displayBuffer.data() + (PANEL_COUNT - 1 - panel) * PANEL_WIDTH, columns);
+        REQUIRE(createWriteBuffer(columns, full, buffer) == WRITE_BUFFER_SIZE);
+        REQUIRE(buffer == legacyWriteBuffer(displayBuffer, panel, true));
+
+        extractPanelColumns<PANEL_WIDTH, false>(displayBuffer.data() + panel * PANEL_WIDTH, columns);
+        REQUIRE(createWriteBuffer(columns, full, buffer) == WRITE_BUFFER_SIZE);
+        REQUIRE(buffer == legacyWriteBuffer(displayBuffer, panel, false));
+    }
+}
+
+TEST_CASE("HT1632 column extractors per panel width", "[ht1632]") {
+    auto displayBuffer = randomDisplay(11);
+
+    for (size_t width : display::SUPPORTED_PANEL_WIDTHS) {
+        PanelColumns columns;
+        columns.fill(0xAA);
+
+        columnExtractor(width, false)(displayBuffer.data(), columns);
+        for (size_t col = 0; col < RAM_COLUMNS; ++col) {
+            REQUIRE(columns[col] == (col < width ? REVERSE_BITS[displayBuffer[col]] : 0));
+        }
+
+        columnExtractor(width, true)(displayBuffer.data(), columns);
+        for (size_t col = 0; col < width; ++col) {
+            REQUIRE(columns[col] == displayBuffer[width - 1 - col]);
+        }
+    }
+
+    REQUIRE(columnExtractor(12, false) == nullptr);
+    REQUIRE(columnExtractor(64, true) == nullptr);
+}
+
+TEST_CASE("HT1632 frame encoding does not allocate", "[ht1632]") {
+    auto displayBuffer = randomDisplay(5);
+    std::array<PanelColumns, PANEL_COUNT> sent{};
+    size_t bytes = 0;
+
+    const size_t before = allocations.load();
+    for (uint8_t frame = 0; frame < 16; ++frame) {
+        displayBuffer[frame] = static_cast<uint8_t>(~displayBuffer[frame]);
+        for (size_t panel = 0; panel < PANEL_COUNT; ++panel) {
+            PanelColumns columns;
+            WriteBuffer buffer;
+            extractPanelColumns<PANEL_WIDTH, true>(displayBuffer.data() + (PANEL_COUNT - 1 - panel) * PANEL_WIDTH, columns);
+            auto plan = planWrite(frame == 0 ? nullptr : &sent[panel], columns);
+            bytes += createWriteBuffer(columns, plan, buffer);
+            sent[panel] = columns;
+        }
+    }
+    const size_t after = allocations.load();
+
+    REQUIRE(bytes > 0);
+    REQUIRE(after == before);
+}
+
+TEST_CASE("HT1632 frame packing benchmark", "[.][benchmark]") {
+    auto displayBuffer = randomDisplay(7);
+
+    BENCHMARK_ADVANCED("bitwise packing, 4 panels")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&](int frame) {
+            displayBuffer[static_cast<size_t>(frame) % WIDTH] = static_cast<uint8_t>(frame);
+            unsigned checksum = 0;
+            for (size_t panel = 0; panel < PANEL_COUNT; ++panel) {
+                for (auto byte : legacyWriteBuffer(displayBuffer, panel, true)) {
+                    checksum += byte;
+                }
+            }
+            return checksum;
+        });
+    };
+
+    BENCHMARK_ADVANCED("table packing, 4 panels")(Catch::Benchmark::Chronometer meter) {
+        WritePlan full;
+        full.nibbles = RAM_NIBBLES;
+
+        meter.measure([&](int frame) {
+            displayBuffer[static_cast<size_t>(frame) % WIDTH] = static_cast<uint8_t>(frame);
+            unsigned checksum = 0;
+            PanelColumns columns;
+            WriteBuffer buffer;
+            for (size_t panel = 0; panel < PANEL_COUNT; ++panel) {
+                extractPanelColumns<PANEL_WIDTH, true>(displayBuffer.data() + (PANEL_COUNT - 1 - panel) * PANEL_WIDTH, columns);
+                createWriteBuffer(columns, full, buffer);
+                for (auto byte : buffer) {
+                    checksum += byte;
+                }
+            }
+            return checksum;
+        });
+    };
+}
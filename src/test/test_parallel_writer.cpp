@@ -0,0 +1,144 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "ht1632_driver.hpp"
+#include "loopback_transport.hpp"
+#include "parallel_writer.hpp"
+
+using namespace std::chrono_literals;
+using namespace ht1632;
+
+namespace {
+
+Frame randomFrame(uint32_t seed, size_t width)
+{
+    Frame frame(width);
+    for (auto& column : frame) {
+        seed = seed * 1664525U + 1013904223U;
+        column = static_cast<uint8_t>(seed >> 24);
+    }
+    return frame;
+}
+
+// One loopback transport and driver per chain of the geometry
+struct Wall
+{
+    explicit Wall(const display::Geometry& geometry)
+    {
+        std::vector<ParallelWriter::Chain> chains;
+        for (size_t chain = 0; chain < geometry.chainCount(); ++chain) {
+            loopbacks.push_back(std::make_unique<LoopbackTransport>(geometry.panelsIn(chain)));
+            drivers.push_back(std::make_unique<Driver>(*loopbacks.back(), geometry, chain));
+            chains.push_back([driver = drivers.back().get()](const Frame& frame) { driver->writeFrame(frame); });
+        }
+        writer = std::make_unique<ParallelWriter>(std::move(chains));
+    }
+
+    std::vector<std::unique_ptr<LoopbackTransport>> loopbacks;
+    std::vector<std::unique_ptr<Driver>> drivers;
+    std::unique_ptr<ParallelWriter> writer;
+};
+
+} // namespace
+
+TEST_CASE("Parallel writer runs every chain on each frame", "[output]") {
+    std::atomic<int> calls{0};
+    std::vector<ParallelWriter::Chain> chains;
+    for (int i = 0; i < 3; ++i) {
+        chains.push_back([&calls](const Frame&) {
+            std::this_thread::sleep_for(2ms);
+            calls++;
+        });
+    }
+    ParallelWriter writer(std::move(chains));
+
+    const Frame frame(128, 0);
+    for (int i = 1; i <= 5; ++i) {
+        writer.write(frame);
+        // Nothing is still writing once write() returns
+        REQUIRE(calls.load() == 3 * i);
+    }
+    REQUIRE(writer.getStats().frames == 5);
+}
+
+TEST_CASE("Parallel writer chains overlap", "[output]") {
+    // The first chain can only finish while the second one runs
+    std::atomic<bool> second_running{false};
+    std::atomic<bool> overlapped{false};
+
+    ParallelWriter writer({
+        [&](const Frame&) {
+            auto deadline = std::chrono::steady_clock::now() + 1s;
+            while (!second_running && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            overlapped = second_running.load();
+        },
+        [&](const Frame&) {
+            second_running = true;
+            std::this_thread::sleep_for(5ms);
+            second_running = false;
+        },
+    });
+
+    writer.write(Frame(128, 0));
+    REQUIRE(overlapped);
+}
+
+TEST_CASE("Parallel chains show the same image as one chain", "[output]") {
+    const bool flip = GENERATE(true, false);
+
+    display::Geometry single(8, 32, flip);
+    single.panel_order = {0, 2, 4, 6, 1, 3, 5, 7};
+    display::Geometry split = single;
+    split.chains = {3, 5};
+
+    Wall one(single);
+    Wall two(split);
+
+    for (uint32_t seed = 1; seed < 5; ++seed) {
+        auto frame = randomFrame(seed, single.width());
+        one.writer->write(frame);
+        two.writer->write(frame);
+
+        for (size_t panel = 0; panel < single.panel_count; ++panel) {
+            const size_t chain = panel < 3 ? 0 : 1;
+            const size_t index = panel - split.firstPanelOf(chain);
+            REQUIRE(two.loopbacks[chain]->panel(index).columns() == one.loopbacks[0]->panel(panel).columns());
+        }
+    }
+}
+
+TEST_CASE("Parallel writer benchmark", "[.][benchmark]") {
+    std::vector<Frame> frames;
+    for (uint32_t seed = 0; seed < 16; ++seed) {
+        frames.push_back(randomFrame(seed, 16 * 32));
+    }
+
+    auto run = [&](const char* name, std::vector<size_t> chains) {
+        display::Geometry geometry(16, 32, true);
+        geometry.chains = std::move(chains);
+        Wall wall(geometry);
+
+        BENCHMARK_ADVANCED(name)(Catch::Benchmark::Chronometer meter) {
+            for (auto& loopback : wall.loopbacks) {
+                loopback->clear();
+            }
+            meter.measure([&](int i) {
+                wall.writer->write(frames[static_cast<size_t>(i) % frames.size()]);
+                return wall.loopbacks[0]->getBytesSent();
+            });
+        };
+    };
+
+    run("16 panels, 1 chain", {});
+    run("16 panels, 2 chains", {8, 8});
+    run("16 panels, 4 chains", {4, 4, 4, 4});
+}
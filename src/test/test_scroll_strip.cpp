@@ -0,0 +1,149 @@
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "font.hpp"
+#include "geometry.hpp"
+#include "scroll_strip.hpp"
+
+using namespace display;
+
+static constexpr size_t WIDTH = 128;
+
+static std::vector<uint8_t> sequence(size_t size)
+{
+    std::vector<uint8_t> content(size);
+    for (size_t i = 0; i < size; ++i) {
+        content[i] = static_cast<uint8_t>(i + 1);
+    }
+    return content;
+}
+
+TEST_CASE("Scroll strip windows", "[scroll]") {
+    ScrollStrip strip;
+    const auto content = sequence(10);
+    uint8_t window[4];
+
+    SECTION("Window at an offset") {
+        strip.assign(content, 4);
+        REQUIRE(strip.size() == 10);
+        REQUIRE(strip.overflows());
+
+        strip.blit(window, 3);
+        REQUIRE(std::vector<uint8_t>(window, window + 4) == std::vector<uint8_t>{4, 5, 6, 7});
+    }
+
+    SECTION("Lead columns are blank") {
+        strip.assign(content, 4, 2);
+        REQUIRE(strip.size() == 12);
+
+        strip.blit(window, 0);
+        REQUIRE(std::vector<uint8_t>(window, window + 4) == std::vector<uint8_t>{0, 0, 1, 2});
+    }
+
+    SECTION("Past the end is blank") {
+        strip.assign(content, 4);
+
+        strip.blit(window, 8);
+        REQUIRE(std::vector<uint8_t>(window, window + 4) == std::vector<uint8_t>{9, 10, 0, 0});
+
+        strip.blit(window, 1000);
+        REQUIRE(std::vector<uint8_t>(window, window + 4) == std::vector<uint8_t>{0, 0, 0, 0});
+    }
+
+    SECTION("Content that fits does not overflow") {
+        strip.assign(content, 10);
+        REQUIRE_FALSE(strip.overflows());
+
+        strip.clear();
+        REQUIRE(strip.size() == 0);
+    }
+}
+
+TEST_CASE("Lazy scroll strip matches the laid out one", "[scroll]") {
+    const auto content = sequence(1000);
+    auto source = [&](size_t first, size_t count, uint8_t* destination) {
+        for (size_t i = 0; i < count; ++i) {
+            destination[i] = first + i < content.size() ? content[first + i] : 0;
+        }
+    };
+
+    for (size_t lead : {size_t{0}, size_t{3}, size_t{200}}) {
+        ScrollStrip eager;
+        ScrollStrip lazy;
+        eager.assign(content, WIDTH, lead);
+        lazy.assign(source, content.size(), WIDTH, lead);
+        REQUIRE(lazy.size() == eager.size());
+
+        // Forwards as when scrolling, then back to the start
+        std::vector<uint8_t> expected(WIDTH);
+        std::vector<uint8_t> actual(WIDTH);
+        for (size_t offset : {size_t{0}, size_t{1}, size_t{2}, size_t{150}, size_t{300}, size_t{999}, size_t{1200}, size_t{0}, size_t{5000}}) {
+            eager.blit(expected.data(), offset);
+            lazy.blit(actual.data(), offset);
+            REQUIRE(actual == expected);
+        }
+        for (size_t offset = 0; offset < lazy.size(); ++offset) {
+            eager.blit(expected.data(), offset);
+            lazy.blit(actual.data(), offset);
+            REQUIRE(actual == expected);
+        }
+
+        // Only the window and the lookahead are held
+        REQUIRE(lazy.resident() == WIDTH + ScrollStrip::LOOKAHEAD);
+    }
+}
+
+TEST_CASE("Scroll strip benchmark", "[.][benchmark]") {
+    const std::string sentence = "The quick brown fox jumps over the lazy dog. ";
+
+    for (size_t repeats : {size_t{4}, size_t{40}, size_t{400}}) {
+        std::string text;
+        for (size_t i = 0; i < repeats; ++i) {
+            text += sentence;
+        }
+        const auto rendered = font::renderString(text);
+        const size_t steps = rendered.size() - WIDTH;
+        const auto suffix = " (" + std::to_string(rendered.size()) + " columns)";
+
+        // What every scroll step used to do: clear, copy column by column, compare
+        Framebuffer previous(WIDTH, 0);
+        BENCHMARK_ADVANCED("column copy" + suffix)(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                const size_t offset = static_cast<size_t>(i) % steps;
+                Framebuffer frame(WIDTH, 0);
+                for (size_t pos = 0, column = offset; pos < WIDTH && column < rendered.size(); ++pos, ++column) {
+                    frame[pos] = rendered.at(column);
+                }
+                const bool changed = frame != previous;
+                previous = frame;
+                return changed;
+            });
+        };
+
+        ScrollStrip strip;
+        strip.assign(rendered, WIDTH);
+        Framebuffer frame(WIDTH, 0);
+        BENCHMARK_ADVANCED("window copy" + suffix)(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                strip.blit(frame.data(), static_cast<size_t>(i) % steps);
+                return frame[0];
+            });
+        };
+
+        // Rendering the columns as they scroll into view
+        const font::LazyText lazy(text);
+        ScrollStrip lazyStrip;
+        lazyStrip.assign([&](size_t first, size_t count, uint8_t* destination) { lazy.render(first, count, destination); },
+                         lazy.width(), WIDTH);
+        BENCHMARK_ADVANCED("lazy window copy" + suffix)(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                lazyStrip.blit(frame.data(), static_cast<size_t>(i) % steps);
+                return frame[0];
+            });
+        };
+    }
+}
@@ -7,6 +7,7 @@
 
 #include "sequence.hpp"
 #include "display.hpp"
+#include "font.hpp"
 
 using namespace sequence;
 using namespace std::chrono_literals;
@@ -15,7 +16,7 @@ namespace display {
     // Simple test display implementation
     class TestDisplay : public Display {
     public:
-        TestDisplay() : Display([](){}, [](){}) {}
+        TestDisplay() : Display(128, [](){}, [](){}) {}
         void setBrightness(int) override {}
     private:
         void update() override {}
@@ -140,3 +141,109 @@ TEST_CASE("SequenceManager stress test for null pointer", "[sequence][stress]")
     
     REQUIRE(operations.load() > 0);
 }
+
+// Polls until the condition holds or the timeout passes
+template<typename Condition>
+static bool waitFor(Condition condition, std::chrono::milliseconds timeout = 1000ms) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(2ms);
+    }
+    return condition();
+}
+
+TEST_CASE("SequenceManager sleeps until the next event", "[sequence][timing]") {
+    auto display = std::make_unique<display::TestDisplay>();
+    SequenceManager manager(std::move(display));
+
+    DisplayState state;
+    state.text = "Hello";
+
+    SECTION("A single long state does not poll") {
+        manager.addSequenceState("idle", state, 30.0);
+        auto wakeups = manager.getWakeupCount();
+
+        std::this_thread::sleep_for(150ms);
+        REQUIRE(manager.getWakeupCount() == wakeups);
+        REQUIRE(manager.getCurrentSequenceId() == "idle");
+    }
+
+    SECTION("Advances when the display time ends") {
+        manager.addSequenceState("a", state, 0.05);
+        manager.addSequenceState("b", state, 30.0);
+        REQUIRE(manager.getCurrentSequenceId() == "a");
+
+        REQUIRE(waitFor([&]() { return manager.getCurrentSequenceId() == "b"; }));
+        REQUIRE(manager.getWakeupCount() < 5);
+    }
+
+    SECTION("TTL expiry of a waiting state wakes the manager") {
+        manager.addSequenceState("keep", state, 30.0);
+        manager.addSequenceState("temp", state, 30.0, 0.05);
+        REQUIRE(manager.getSequenceCount() == 2);
+
+        REQUIRE(waitFor([&]() { return manager.getSequenceCount() == 1; }));
+        REQUIRE(manager.getCurrentSequenceId() == "keep");
+    }
+
+    SECTION("States without ttl never expire") {
+        manager.addSequenceState("a", state, 0.01);
+        manager.addSequenceState("b", state, 0.01);
+
+        std::this_thread::sleep_for(60ms);
+        REQUIRE(manager.getSequenceCount() == 2);
+    }
+
+    SECTION("Clearing the current state moves on immediately") {
+        manager.addSequenceState("a", state, 30.0);
+        manager.addSequenceState("b", state, 30.0);
+        REQUIRE(manager.getCurrentSequenceId() == "a");
+
+        manager.clearSequenceById("a");
+        REQUIRE(waitFor([&]() { return manager.getCurrentSequenceId() == "b"; }));
+    }
+}
+
+TEST_CASE("Display state scroll speed from JSON", "[sequence]") {
+    REQUIRE_FALSE(parseDisplayStateFromJSON({{"text", "Hello"}}).scroll_speed.has_value());
+    REQUIRE(parseDisplayStateFromJSON({{"text", "Hello"}, {"scroll_speed", 40}}).scroll_speed == 40.0);
+    REQUIRE(parseDisplayStateFromJSON({{"text", "Hello"}, {"scroll_speed", 7.5}}).scroll_speed == 7.5);
+    REQUIRE_FALSE(parseDisplayStateFromJSON({{"text", "Hello"}, {"scroll_speed", 0}}).scroll_speed.has_value());
+}
+
+TEST_CASE("Display state text is decoded to glyphs", "[sequence]") {
+    auto state = parseDisplayStateFromJSON({{"text", "21\u2103 \u2192 Z\u00fcrich"}});
+    REQUIRE(state.text == font::toGlyphs("21\u2103 \u2192 Z\u00fcrich"));
+    REQUIRE(font::fromGlyphs(*state.text) == "21\u00b0C \u2192 Zurich");
+
+    state = parseDisplayStateFromJSON({{"show_time", true}, {"time_format", "%H\u2236%M"}});
+    REQUIRE(state.time_format == "%H?%M");
+}
+
+TEST_CASE("Message parse to render benchmark", "[.][benchmark]") {
+    // What an MQTT message costs from its JSON to the first window on the display
+    const std::string sentence = "Z\u00fcrich 21\u2103 \u2600 \u2192 \u201cStra\u00dfe\u201d \u00e6\u00f8\u00e5 \u2026 ";
+    std::vector<uint8_t> window(128);
+
+    for (size_t repeats : {size_t{32}, size_t{320}}) {
+        std::string text;
+        for (size_t i = 0; i < repeats; ++i) {
+            text += sentence;
+        }
+        const nlohmann::json message = {{"text", text}};
+
+        BENCHMARK("parse and render (" + std::to_string(text.size()) + " bytes)") {
+            auto state = parseDisplayStateFromJSON(message);
+            font::LazyText rendered(std::move(*state.text));
+            rendered.render(0, window.size(), window.data());
+            return rendered.width();
+        };
+
+        BENCHMARK("decode to glyphs (" + std::to_string(text.size()) + " bytes)") {
+            return font::toGlyphs(text);
+        };
+    }
+}
@@ -0,0 +1,149 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+#include <catch2/catch_all.hpp>
+
+#include "ht1632.hpp"
+#include "spidev_transport.hpp"
+
+using namespace ht1632;
+
+namespace {
+
+struct Transfer
+{
+    std::vector<uint8_t> data;
+    uint16_t delay_us;
+    uint32_t speed_hz;
+};
+
+// Stands in for the spidev and GPIO line request descriptors
+struct FakeDevices
+{
+    int spi_fd = ::open("/dev/null", O_RDWR);
+    int cs_fd = ::open("/dev/null", O_RDWR);
+
+    std::vector<uint64_t> cs_values;              // line levels after each chip select ioctl
+    std::vector<std::vector<Transfer>> messages;  // one entry per SPI_IOC_MESSAGE
+
+    int ioctl(int fd, unsigned long request, void* arg)
+    {
+        if (fd == cs_fd && request == GPIO_V2_LINE_SET_VALUES_IOCTL) {
+            auto* values = static_cast<gpio_v2_line_values*>(arg);
+            cs_values.push_back(values->bits & values->mask);
+            return 0;
+        }
+
+        // SPI_IOC_MESSAGE(n) encodes the batch size in the request
+        if (fd == spi_fd && _IOC_TYPE(request) == SPI_IOC_MAGIC && _IOC_NR(request) == 0) {
+            const size_t count = _IOC_SIZE(request) / sizeof(spi_ioc_transfer);
+            auto* transfers = static_cast<spi_ioc_transfer*>(arg);
+
+            std::vector<Transfer> message;
+            for (size_t i = 0; i < count; ++i) {
+                const auto* tx = reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(transfers[i].tx_buf));
+                Transfer transfer;
+                transfer.data.assign(tx, tx + transfers[i].len);
+                transfer.delay_us = transfers[i].delay_usecs;
+                transfer.speed_hz = transfers[i].speed_hz;
+                message.push_back(transfer);
+            }
+            messages.push_back(message);
+            return 0;
+        }
+
+        return -1;
+    }
+
+    std::unique_ptr<SpidevTransport> bus(size_t cs_count = 4)
+    {
+        return std::make_unique<SpidevTransport>(spi_fd, cs_fd, cs_count, 200000,
+            [this](int fd, unsigned long request, void* arg) { return ioctl(fd, request, arg); });
+    }
+};
+
+} // namespace
+
+TEST_CASE("Spidev transport drives chip selects through GPIO lines", "[spidev]") {
+    FakeDevices devices;
+    auto bus = devices.bus();
+
+    bus->select(2);
+    bus->select(HT1632_PANEL_ALL);
+    bus->select(HT1632_PANEL_NONE);
+
+    // Active low, only the selected line is driven low
+    REQUIRE(devices.cs_values == std::vector<uint64_t>{0b1011, 0b0000, 0b1111});
+    REQUIRE(devices.messages.empty());
+}
+
+TEST_CASE("Spidev transport batches transfers into one message", "[spidev]") {
+    FakeDevices devices;
+    auto bus = devices.bus();
+
+    const uint8_t header[] = {0xA0, 0x3F};
+    const uint8_t data[] = {0x12, 0x34, 0x56};
+
+    bus->select(0, 7);
+    bus->write(header, sizeof(header));
+    bus->write(data, sizeof(data), 2);
+    REQUIRE(devices.messages.empty());
+
+    bus->select(HT1632_PANEL_NONE);
+
+    REQUIRE(devices.messages.size() == 1);
+    const auto& message = devices.messages[0];
+    REQUIRE(message.size() == 3);
+
+    // Setup delay as an empty transfer right after selecting
+    REQUIRE(message[0].data.empty());
+    REQUIRE(message[0].delay_us == 7);
+    REQUIRE(message[1].data == std::vector<uint8_t>{0xA0, 0x3F});
+    REQUIRE(message[1].delay_us == 0);
+    REQUIRE(message[2].data == std::vector<uint8_t>{0x12, 0x34, 0x56});
+    REQUIRE(message[2].delay_us == 2);
+    REQUIRE(message[2].speed_hz == 200000);
+
+    // Two chip select changes and one SPI message
+    REQUIRE(bus->getSyscallCount() == 3);
+}
+
+TEST_CASE("Spidev transport flushes before changing the selection", "[spidev]") {
+    FakeDevices devices;
+    auto bus = devices.bus();
+
+    const uint8_t first[] = {1};
+    const uint8_t second[] = {2};
+
+    bus->select(0);
+    bus->write(first, 1);
+    bus->select(1);
+    bus->write(second, 1);
+    bus->flush();
+    bus->flush();
+
+    REQUIRE(devices.messages.size() == 2);
+    REQUIRE(devices.messages[0][0].data == std::vector<uint8_t>{1});
+    REQUIRE(devices.messages[1][0].data == std::vector<uint8_t>{2});
+}
+
+TEST_CASE("Spidev transport splits batches that outgrow the message", "[spidev]") {
+    FakeDevices devices;
+    auto bus = devices.bus();
+
+    const uint8_t byte = 0x55;
+    for (size_t i = 0; i < SpidevTransport::MAX_BATCH + 1; ++i) {
+        bus->write(&byte, 1);
+    }
+    bus->flush();
+
+    REQUIRE(devices.messages.size() == 2);
+    REQUIRE(devices.messages[0].size() == SpidevTransport::MAX_BATCH);
+    REQUIRE(devices.messages[1].size() == 1);
+}
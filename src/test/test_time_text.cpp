@@ -0,0 +1,171 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include "display.hpp"
+#include "font.hpp"
+#include "time_text.hpp"
+
+using namespace display;
+
+static std::tm makeTime(int hour, int minute, int second, int day = 16)
+{
+    std::tm time{};
+    time.tm_year = 124;
+    time.tm_mon = 9;
+    time.tm_mday = day;
+    time.tm_wday = (day + 1) % 7;  // 2024-10-16 was a Wednesday
+    time.tm_hour = hour;
+    time.tm_min = minute;
+    time.tm_sec = second;
+    return time;
+}
+
+static std::vector<uint8_t> renderWhole(const char* format, const std::tm& time)
+{
+    std::stringstream text;
+    text << std::put_time(&time, format);
+    return font::renderString(text.str());
+}
+
+TEST_CASE("Time text renders the same columns as the whole string", "[time]") {
+    TimeText timeText;
+
+    for (const char* format : {TIME_FORMAT_LONG, TIME_FORMAT_SHORT, "%H:%M:%S", "100%% at %d.%m", ""}) {
+        timeText.setFormat(format);
+        for (int second = 0; second < 3; ++second) {
+            const auto time = makeTime(9, 59, 58 + second);
+            timeText.render(time);
+            INFO(format << " " << second);
+            REQUIRE(timeText.columns() == renderWhole(format, time));
+        }
+    }
+}
+
+TEST_CASE("Compiled time formats match strftime", "[time]") {
+    TimeText timeText;
+    const char* formats[] = {
+        "%H %I %M %S %p", "%d %e %m %y %Y %j", "%u %w %A %a %B %b %h", "%T %R %D %F", "%c", "%Z %z %G-W%V",
+    };
+
+    for (const char* format : formats) {
+        timeText.setFormat(format);
+        for (int day = 1; day <= 31; day += 3) {
+            for (int hour : {0, 1, 11, 12, 13, 23}) {
+                auto time = makeTime(hour, 5, 9, day);
+                time.tm_mon = day % 12;
+                time.tm_yday = day * 7;
+                time.tm_wday = day % 7;
+                timeText.render(time);
+                INFO(format << " day " << day << " hour " << hour);
+                REQUIRE(timeText.columns() == renderWhole(format, time));
+            }
+        }
+    }
+}
+
+TEST_CASE("Local time is converted once per minute", "[time]") {
+    // A zone with daylight saving, the change to summer time is at 02:00 local time on 2024-03-31
+    const char* previous = std::getenv("TZ");
+    const std::string saved = previous ? previous : "";
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+
+    LocalTime localTime;
+    const std::time_t change = 1711846800;  // 2024-03-31 01:00:00 UTC
+    for (std::time_t time = change - 150; time < change + 150; ++time) {
+        std::tm expected{};
+        localtime_r(&time, &expected);
+        const auto& actual = localTime.at(time);
+        INFO(time);
+        REQUIRE(actual.tm_hour == expected.tm_hour);
+        REQUIRE(actual.tm_min == expected.tm_min);
+        REQUIRE(actual.tm_sec == expected.tm_sec);
+        REQUIRE(actual.tm_isdst == expected.tm_isdst);
+    }
+
+    if (previous) {
+        setenv("TZ", saved.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+
+TEST_CASE("Time text reports the columns that changed", "[time]") {
+    TimeText timeText;
+    timeText.setFormat("%H:%M:%S");
+
+    auto changed = timeText.render(makeTime(12, 34, 56));
+    REQUIRE(changed.first == 0);
+    REQUIRE(changed.last == timeText.columns().size());
+
+    SECTION("Same time") {
+        REQUIRE(timeText.render(makeTime(12, 34, 56)).empty());
+    }
+
+    SECTION("Only the seconds") {
+        const size_t seconds = font::stringWidth("12:34:");
+        changed = timeText.render(makeTime(12, 34, 57));
+        REQUIRE(changed.first == seconds);
+        REQUIRE(changed.last == timeText.columns().size());
+    }
+
+    SECTION("Only the minutes") {
+        const size_t minutes = font::stringWidth("12:");
+        changed = timeText.render(makeTime(12, 35, 56));
+        REQUIRE(changed.first == minutes);
+        REQUIRE(changed.last == minutes + font::stringWidth("35"));
+    }
+
+    SECTION("A field that changes width moves everything after it") {
+        timeText.setFormat("%A %H");
+        const auto wednesday = makeTime(12, 0, 0, 16);
+        timeText.render(wednesday);
+        const size_t longer = timeText.columns().size();
+
+        changed = timeText.render(makeTime(12, 0, 0, 17));
+        REQUIRE(changed.first == 0);
+        REQUIRE(changed.last == longer);  // Thursday is narrower, the old end is cleared too
+        REQUIRE(timeText.columns() == renderWhole("%A %H", makeTime(12, 0, 0, 17)));
+    }
+}
+
+TEST_CASE("Time text rendering benchmark", "[.][benchmark]") {
+    for (const char* format : {TIME_FORMAT_SHORT, TIME_FORMAT_LONG}) {
+        const std::string suffix = std::string(" (") + format + ")";
+        TimeText timeText;
+        timeText.setFormat(format);
+
+        // What every second used to cost: localtime, put_time into a stringstream, all glyphs
+        BENCHMARK_ADVANCED("whole string every second" + suffix)(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&](int i) {
+                const std::time_t now = 1729082096 + i;
+                return renderWhole(format, *std::localtime(&now)).size();
+            });
+        };
+
+        BENCHMARK_ADVANCED("compiled format every second" + suffix)(Catch::Benchmark::Chronometer meter) {
+            LocalTime localTime;
+            meter.measure([&](int i) {
+                return timeText.render(localTime.at(1729082096 + i)).last;
+            });
+        };
+
+        // Formatting alone, the fields are compared but nothing is redrawn
+        BENCHMARK_ADVANCED("compiled format, same time" + suffix)(Catch::Benchmark::Chronometer meter) {
+            const auto time = makeTime(12, 34, 56);
+            timeText.render(time);
+            meter.measure([&] {
+                return timeText.render(time).last;
+            });
+        };
+    }
+}
@@ -0,0 +1,107 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "timer.hpp"
+
+using namespace std::chrono_literals;
+
+TEST_CASE("Timer periodic and one-shot tasks", "[timer]") {
+    SECTION("Periodic timer runs repeatedly") {
+        std::atomic<int> runs{0};
+        auto timer = timer::createTimer(5ms, [&]() { runs++; });
+
+        std::this_thread::sleep_for(60ms);
+        timer->stop();
+
+        REQUIRE(runs.load() >= 3);
+        REQUIRE(timer->getStats().runs == static_cast<uint64_t>(runs.load()));
+    }
+
+    SECTION("One-shot timer runs exactly once") {
+        std::atomic<int> runs{0};
+        auto timer = timer::createTimeout(5ms, [&]() { runs++; });
+
+        std::this_thread::sleep_for(40ms);
+        REQUIRE(runs.load() == 1);
+    }
+
+    SECTION("Stopped timer never runs") {
+        std::atomic<int> runs{0};
+        auto timer = timer::createTimeout(20ms, [&]() { runs++; });
+        timer->stop();
+
+        std::this_thread::sleep_for(40ms);
+        REQUIRE(runs.load() == 0);
+    }
+
+    SECTION("Timer can be restarted after stop") {
+        std::atomic<int> runs{0};
+        timer::Timer timer;
+        timer.setTimeout([&]() { runs++; }, 5ms);
+        timer.stop();
+        timer.setTimeout([&]() { runs += 10; }, 5ms);
+
+        std::this_thread::sleep_for(40ms);
+        REQUIRE(runs.load() == 10);
+    }
+}
+
+TEST_CASE("Timer callbacks share one scheduler thread", "[timer]") {
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    auto record = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+    };
+
+    auto a = timer::createTimer(3ms, record);
+    auto b = timer::createTimer(7ms, record);
+    auto c = timer::createTimeout(10ms, record);
+
+    std::this_thread::sleep_for(50ms);
+    a->stop();
+    b->stop();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    REQUIRE(threads.size() == 1);
+    REQUIRE(threads.count(std::this_thread::get_id()) == 0);
+}
+
+TEST_CASE("Timer stop waits for a running callback", "[timer]") {
+    std::atomic<bool> inside{false};
+    std::atomic<bool> finished{false};
+
+    auto timer = timer::createTimeout(1ms, [&]() {
+        inside = true;
+        std::this_thread::sleep_for(30ms);
+        finished = true;
+    });
+
+    while (!inside.load()) {
+        std::this_thread::sleep_for(1ms);
+    }
+    timer->stop();
+
+    REQUIRE(finished.load());
+}
+
+TEST_CASE("Timer reports missed deadlines", "[timer]") {
+    auto before = timer::getSchedulerStats().missed_deadlines;
+
+    // The slow task overruns its own period and delays the fast one
+    auto slow = timer::createTimer(5ms, []() { std::this_thread::sleep_for(20ms); });
+    auto fast = timer::createTimer(2ms, []() {});
+
+    std::this_thread::sleep_for(80ms);
+    slow->stop();
+    fast->stop();
+
+    REQUIRE(slow->getStats().missed_deadlines > 0);
+    REQUIRE(fast->getStats().missed_deadlines > 0);
+    REQUIRE(fast->getStats().worst_lateness >= timer::MISSED_DEADLINE_TOLERANCE);
+    REQUIRE(timer::getSchedulerStats().missed_deadlines > before);
+}
@@ -1,7 +1,11 @@
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -12,6 +16,8 @@
 
 #define CATCH_CONFIG_MAIN
 
+static constexpr size_t WIDTH = 128;
+
 std::string to_binary(long long);
 
 std::string to_binary(long long value) {
@@ -25,8 +31,8 @@ std::string to_binary(long long value) {
 
 TEST_CASE("scroll up", "[transition]") {
     transition::ScrollTransition scroll_transition(transition::ScrollTransition::Direction::UP, 1.0);
-    std::array<uint8_t, X_MAX> from_buffer = {0x00, 0xFF};
-    std::array<uint8_t, X_MAX> to_buffer = {0xFF, 0x00};
+    display::Framebuffer from_buffer = {0x00, 0xFF};
+    display::Framebuffer to_buffer = {0xFF, 0x00};
 
     scroll_transition.start(from_buffer, to_buffer);
     REQUIRE(scroll_transition.update(0.0)[0] == 0x00);
@@ -41,8 +47,8 @@ TEST_CASE("scroll up", "[transition]") {
 
 TEST_CASE("scroll down", "[transition]") {
     transition::ScrollTransition scroll_transition(transition::ScrollTransition::Direction::DOWN, 1.0);
-    std::array<uint8_t, X_MAX> from_buffer = {0x00, 0xFF};
-    std::array<uint8_t, X_MAX> to_buffer = {0xFF, 0x00};
+    display::Framebuffer from_buffer = {0x00, 0xFF};
+    display::Framebuffer to_buffer = {0xFF, 0x00};
     
     scroll_transition.start(from_buffer, to_buffer);
     REQUIRE(scroll_transition.update(0.0)[0] == 0x00);
@@ -61,8 +67,8 @@ TEST_CASE("scroll should move without gaps", "[transition]") {
         transition::ScrollTransition(transition::ScrollTransition::Direction::UP, duration),
         transition::ScrollTransition(transition::ScrollTransition::Direction::DOWN, duration),
     };
-    std::array<uint8_t, X_MAX> from_buffer = {0x00};
-    std::array<uint8_t, X_MAX> to_buffer = {0xFF};
+    display::Framebuffer from_buffer = {0x00};
+    display::Framebuffer to_buffer = {0xFF};
 
     for (size_t i = 0; i < scroll_directions.size(); ++i) {
         auto& scroll_transition = scroll_directions[i];
@@ -82,12 +88,8 @@ TEST_CASE("scroll should move without gaps", "[transition]") {
 
 TEST_CASE("wipe right", "[transition]") {
     transition::WipeTransition wipe_transition(transition::WipeTransition::Direction::LEFT_TO_RIGHT, 1.0);
-    std::array<uint8_t, X_MAX> from_buffer = {{}};
-    std::array<uint8_t, X_MAX> to_buffer = {{}};
-    for (size_t i = 0; i < X_MAX; ++i) {
-        from_buffer[i] = static_cast<uint8_t>(0x0F);
-        to_buffer[i] = static_cast<uint8_t>(0xF0);
-    }
+    display::Framebuffer from_buffer(WIDTH, 0x0F);
+    display::Framebuffer to_buffer(WIDTH, 0xF0);
 
     wipe_transition.start(from_buffer, to_buffer);
 
@@ -132,3 +134,208 @@ TEST_CASE("wipe right", "[transition]") {
         {127, 0xF0},
     });
 }
+
+static display::Framebuffer randomFrame(size_t width, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    display::Framebuffer frame(width);
+    for (auto& column : frame) {
+        column = static_cast<uint8_t>(rng());
+    }
+    return frame;
+}
+
+TEST_CASE("scroll shifts every column on its own", "[transition]") {
+    // Odd width so the columns after the last whole word are covered too
+    const auto from_buffer = randomFrame(WIDTH + 3, 1);
+    const auto to_buffer = randomFrame(WIDTH + 3, 2);
+
+    for (auto direction : {transition::ScrollTransition::Direction::UP, transition::ScrollTransition::Direction::DOWN}) {
+        for (unsigned shift = 0; shift <= 8; ++shift) {
+            transition::ScrollTransition scroll_transition(direction, 8.0);
+            scroll_transition.start(from_buffer, to_buffer);
+            const auto result = scroll_transition.update(shift);
+
+            for (size_t x = 0; x < result.size(); ++x) {
+                const unsigned from = from_buffer[x];
+                const unsigned to = to_buffer[x];
+                const auto expected = static_cast<uint8_t>(direction == transition::ScrollTransition::Direction::UP
+                    ? (from >> shift) | (to << (8 - shift))
+                    : (from << shift) | (to >> (8 - shift)));
+                INFO("Shift: " << shift << ", X: " << x);
+                REQUIRE(result[x] == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("transitions render in place", "[transition]") {
+    const auto from_buffer = randomFrame(WIDTH + 3, 3);
+    const auto to_buffer = randomFrame(WIDTH + 3, 4);
+
+    for (int type = static_cast<int>(transition::Type::WIPE_LEFT); type < static_cast<int>(transition::Type::RANDOM); ++type) {
+        // Dissolve draws its pixel order from the seed, both need the same one
+        auto make = [type]() -> std::unique_ptr<transition::TransitionBase> {
+            if (static_cast<transition::Type>(type) == transition::Type::DISSOLVE) {
+                return std::make_unique<transition::DissolveTransition>(1.0, 42);
+            }
+            return transition::TransitionFactory::create(static_cast<transition::Type>(type), 1.0);
+        };
+        auto in_place = make();
+        auto by_value = make();
+        in_place->start(from_buffer, to_buffer);
+        by_value->start(from_buffer, to_buffer);
+
+        display::Framebuffer frame(WIDTH + 3, 0xAA);
+        const uint8_t* storage = frame.data();
+        for (int step = 0; step <= 10; ++step) {
+            in_place->update(0.1, frame);
+            INFO("Type: " << type << ", step: " << step);
+            REQUIRE(frame == by_value->update(0.1));
+            REQUIRE(frame.data() == storage);
+        }
+    }
+}
+
+// Per-pixel threshold and sin() dissolve the event list replaced, kept as reference
+static display::Framebuffer legacyDissolve(const display::Framebuffer& source_buffer, const display::Framebuffer& target_buffer,
+                                           const std::vector<double>& pixel_thresholds, double progress)
+{
+    display::Framebuffer result = source_buffer;
+
+    for (size_t x = 0; x < result.size(); ++x) {
+        uint8_t byte_result = 0;
+        uint8_t sparkle_mask = 0;
+
+        for (size_t bit = 0; bit < 8; ++bit) {
+            size_t pixel_index = x * 8 + bit;
+            double threshold = pixel_thresholds[pixel_index];
+            auto bit_mask = static_cast<uint8_t>(1U << static_cast<unsigned>(bit));
+
+            if (progress >= threshold) {
+                byte_result = static_cast<uint8_t>(byte_result | (target_buffer[x] & bit_mask));
+            } else {
+                byte_result = static_cast<uint8_t>(byte_result | (source_buffer[x] & bit_mask));
+
+                if ((source_buffer[x] & bit_mask) == (target_buffer[x] & bit_mask)) {
+                    double sparkle_zone = 0.1;
+                    double distance_to_threshold = std::abs(progress - threshold);
+
+                    if (distance_to_threshold < sparkle_zone) {
+                        double sparkle_intensity = std::sin(distance_to_threshold * 3.14159 / sparkle_zone);
+                        if (sparkle_intensity > 0.5 &&
+                            (static_cast<uint32_t>(pixel_index * 31) % 100) < static_cast<uint32_t>(sparkle_intensity * 100)) {
+                            sparkle_mask |= bit_mask;
+                        }
+                    }
+                }
+            }
+        }
+
+        result[x] = static_cast<uint8_t>(byte_result ^ sparkle_mask);
+    }
+
+    return result;
+}
+
+TEST_CASE("dissolve matches the per-pixel reference", "[transition]") {
+    std::mt19937 steps(99);
+    std::uniform_real_distribution<double> step_size(0.0, 0.02);
+
+    for (size_t width : {size_t{1}, size_t{13}, WIDTH, size_t{256}}) {
+        for (uint32_t seed : {1u, 7u, 1234u, 99999u}) {
+            // Sparse content so many pixels are the same before and after, and sparkle
+            auto from_buffer = randomFrame(width, seed);
+            auto to_buffer = randomFrame(width, seed + 1);
+            for (size_t x = 0; x < width; ++x) {
+                to_buffer[x] = static_cast<uint8_t>((from_buffer[x] & 0xF0) | (to_buffer[x] & from_buffer[x] & 0x0F));
+            }
+
+            // The thresholds the transition draws from its seed once the width is known
+            std::mt19937 rng(seed);
+            std::uniform_real_distribution<double> dist(0.0, 1.0);
+            std::vector<double> thresholds(width * 8);
+            for (auto& threshold : thresholds) {
+                threshold = dist(rng);
+            }
+
+            const double duration = 1.5;
+            transition::DissolveTransition dissolve(duration, seed);
+            dissolve.start(from_buffer, to_buffer);
+
+            // Irregular frame times, as the frame loop produces them
+            double elapsed = 0.0;
+            display::Framebuffer frame;
+            while (elapsed < duration) {
+                const double delta = step_size(steps);
+                elapsed += delta;
+                dissolve.update(delta, frame);
+
+                const double progress = std::min(1.0, elapsed / duration);
+                INFO("Width: " << width << ", seed: " << seed << ", progress: " << progress);
+                REQUIRE(frame == (progress >= 1.0 ? to_buffer : legacyDissolve(from_buffer, to_buffer, thresholds, progress)));
+            }
+        }
+    }
+}
+
+TEST_CASE("dissolve looks the same for a given seed", "[transition]") {
+    const auto from_buffer = randomFrame(WIDTH, 7);
+    auto to_buffer = from_buffer;
+    to_buffer[10] ^= 0xFF;
+
+    transition::DissolveTransition first(1.0, 1234);
+    transition::DissolveTransition second(1.0, 1234);
+    first.start(from_buffer, to_buffer);
+    second.start(from_buffer, to_buffer);
+
+    std::vector<display::Framebuffer> frames;
+    bool sparkled = false;
+    for (int step = 0; step < 100; ++step) {
+        frames.push_back(first.update(0.01));
+        REQUIRE(frames.back() == second.update(0.01));
+
+        for (size_t x = 0; x < WIDTH; ++x) {
+            sparkled |= (x != 10 && frames.back()[x] != from_buffer[x]);
+        }
+    }
+    REQUIRE(sparkled);
+    REQUIRE(first.update(0.01) == to_buffer);
+
+    // Started again, the same pixel order plays back from the beginning
+    first.start(from_buffer, to_buffer);
+    for (const auto& frame : frames) {
+        REQUIRE(first.update(0.01) == frame);
+    }
+}
+
+TEST_CASE("transition benchmark", "[.][benchmark]") {
+    const auto from_buffer = randomFrame(WIDTH, 5);
+    const auto to_buffer = randomFrame(WIDTH, 6);
+    const std::pair<transition::Type, const char*> types[] = {
+        {transition::Type::WIPE_LEFT, "wipe_left"},
+        {transition::Type::WIPE_RIGHT, "wipe_right"},
+        {transition::Type::DISSOLVE, "dissolve"},
+        {transition::Type::SCROLL_UP, "scroll_up"},
+        {transition::Type::SCROLL_DOWN, "scroll_down"},
+        {transition::Type::SPLIT_CENTER, "split_center"},
+        {transition::Type::SPLIT_SIDES, "split_sides"},
+    };
+
+    for (const auto& [type, name] : types) {
+        auto transition = transition::TransitionFactory::create(type, 1.0);
+        transition->start(from_buffer, to_buffer);
+        display::Framebuffer frame(WIDTH);
+
+        // One frame at 60 Hz, started again once complete
+        BENCHMARK_ADVANCED(std::string(name) + " frame")(Catch::Benchmark::Chronometer meter) {
+            meter.measure([&] {
+                if (transition->isComplete()) {
+                    transition->start(from_buffer, to_buffer);
+                }
+                transition->update(1.0 / MAX_REFRESH_RATE, frame);
+                return frame[0];
+            });
+        };
+    }
+}
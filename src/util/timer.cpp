@@ -1,12 +1,242 @@
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "timer.hpp"
+#include "log_util.hpp"
 
 using namespace std::chrono;
 
 namespace timer
 {
 
+namespace detail
+{
+
+struct Task
+{
+    std::function<void()> function;
+    nanoseconds interval{0};    // zero for one-shot tasks
+    uint64_t generation = 0;    // bumped whenever the queued entry becomes stale
+    bool active = false;
+    bool queued = false;
+    Stats stats;
+};
+
+} // namespace detail
+
+namespace
+{
+
+// Missed deadlines are summarized in the log at most this often
+constexpr seconds MISSED_DEADLINE_REPORT_INTERVAL{10};
+
+// Stale queue entries are purged once they outnumber live ones past this size
+constexpr size_t STALE_ENTRY_PURGE_THRESHOLD = 64;
+
+struct QueueEntry
+{
+    Clock::time_point due;
+    uint64_t generation;
+    std::shared_ptr<detail::Task> task;
+};
+
+// Min-heap ordering on due time
+struct LaterDue
+{
+    bool operator()(const QueueEntry& a, const QueueEntry& b) const { return a.due > b.due; }
+};
+
+class Scheduler
+{
+public:
+    static Scheduler& instance()
+    {
+        // Never destroyed, timers owned by other statics may still stop() during exit
+        static Scheduler* scheduler = new Scheduler();
+        return *scheduler;
+    }
+
+    void schedule(const std::shared_ptr<detail::Task>& task, const std::function<void()>& function,
+                  nanoseconds interval, Clock::time_point due)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        task->function = function;
+        task->interval = interval;
+        task->active = true;
+        invalidate(*task);
+        push({due, task->generation, task});
+        m_wakeup.notify_one();
+    }
+
+    void cancel(const std::shared_ptr<detail::Task>& task)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        task->active = false;
+        invalidate(*task);
+
+        if (std::this_thread::get_id() != m_thread.get_id()) {
+            m_finished.wait(lock, [&] { return m_running != task; });
+        }
+    }
+
+    Stats taskStats(const detail::Task& task)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return task.stats;
+    }
+
+    Stats stats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+private:
+    Scheduler() : m_thread([this] { run(); }) {}
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true)
+        {
+            if (m_queue.empty()) {
+                m_wakeup.wait(lock);
+                continue;
+            }
+
+            const QueueEntry& top = m_queue.front();
+            if (top.generation != top.task->generation) {
+                pop();
+                --m_stale;
+                continue;
+            }
+
+            auto due = top.due;
+            if (Clock::now() < due) {
+                m_wakeup.wait_until(lock, due);
+                continue;
+            }
+
+            QueueEntry entry = pop();
+            detail::Task& task = *entry.task;
+            task.queued = false;
+
+            record(task, Clock::now() - entry.due);
+
+            auto function = task.function;
+            m_running = entry.task;
+            lock.unlock();
+
+            function();
+
+            lock.lock();
+            m_running.reset();
+            m_finished.notify_all();
+
+            // Rescheduled or stopped from within the callback
+            if (!task.active || entry.generation != task.generation) {
+                continue;
+            }
+
+            if (task.interval == nanoseconds::zero()) {
+                task.active = false;
+                continue;
+            }
+
+            // Keep a fixed rate relative to the original schedule, but run
+            // immediately instead of bursting if whole periods were overrun
+            auto next = entry.due + task.interval;
+            auto now = Clock::now();
+            if (next <= now) {
+                record(task, now - next, false);
+                next = now;
+            }
+            push({next, task.generation, entry.task});
+        }
+    }
+
+    void push(QueueEntry entry)
+    {
+        entry.task->queued = true;
+        m_queue.push_back(std::move(entry));
+        std::push_heap(m_queue.begin(), m_queue.end(), LaterDue());
+    }
+
+    QueueEntry pop()
+    {
+        std::pop_heap(m_queue.begin(), m_queue.end(), LaterDue());
+        QueueEntry entry = std::move(m_queue.back());
+        m_queue.pop_back();
+        return entry;
+    }
+
+    // Mark the task's pending entry stale, purging the queue if stale entries pile up
+    void invalidate(detail::Task& task)
+    {
+        ++task.generation;
+        if (!task.queued) {
+            return;
+        }
+        task.queued = false;
+        ++m_stale;
+
+        if (m_stale > STALE_ENTRY_PURGE_THRESHOLD && m_stale * 2 > m_queue.size()) {
+            std::erase_if(m_queue, [](const QueueEntry& e) { return e.generation != e.task->generation; });
+            std::make_heap(m_queue.begin(), m_queue.end(), LaterDue());
+            m_stale = 0;
+        }
+    }
+
+    void record(detail::Task& task, nanoseconds lateness, bool counts_as_run = true)
+    {
+        bool missed = lateness > MISSED_DEADLINE_TOLERANCE;
+
+        for (Stats* stats : {&task.stats, &m_stats}) {
+            if (counts_as_run) {
+                ++stats->runs;
+            }
+            if (missed) {
+                ++stats->missed_deadlines;
+                stats->worst_lateness = std::max(stats->worst_lateness, lateness);
+            }
+        }
+
+        if (missed) {
+            ++m_missed_since_report;
+            m_worst_since_report = std::max(m_worst_since_report, lateness);
+
+            auto now = Clock::now();
+            if (now - m_last_report >= MISSED_DEADLINE_REPORT_INTERVAL) {
+                WARN_LOG("Scheduler missed " << m_missed_since_report << " deadline(s), worst lateness "
+                         << duration_cast<microseconds>(m_worst_since_report).count() << "us");
+                m_last_report = now;
+                m_missed_since_report = 0;
+                m_worst_since_report = nanoseconds::zero();
+            }
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wakeup;
+    std::condition_variable m_finished;
+    std::vector<QueueEntry> m_queue;
+    size_t m_stale = 0;
+    std::shared_ptr<detail::Task> m_running;
+
+    Stats m_stats;
+    Clock::time_point m_last_report{};
+    uint64_t m_missed_since_report = 0;
+    nanoseconds m_worst_since_report{0};
+
+    std::thread m_thread;
+};
+
+} // namespace
+
 std::unique_ptr<Timer> createTimer(
     milliseconds interval,
     const std::function<void()>& callback)
@@ -19,6 +249,26 @@ std::unique_ptr<Timer> createTimer(
     return timer;
 }
 
+std::unique_ptr<Timer> createTimeout(
+    milliseconds delay,
+    const std::function<void()>& callback)
+{
+    auto timer = std::make_unique<Timer>();
+    timer->setTimeout(callback, std::chrono::duration_cast<std::chrono::nanoseconds>(delay));
+
+    return timer;
+}
+
+Stats getSchedulerStats()
+{
+    return Scheduler::instance().stats();
+}
+
+Timer::Timer()
+    : m_task(std::make_shared<detail::Task>())
+{
+}
+
 Timer::~Timer()
 {
     stop();
@@ -26,52 +276,22 @@ Timer::~Timer()
 
 void Timer::setInterval(const std::function<void()>& function, nanoseconds interval)
 {
-    m_clear = false;
-    m_thread = std::thread([this, interval, function]() {
-        std::mutex mutex;
-        auto next_execution = steady_clock::now() + interval;
-
-        while (true)
-        {
-            if (m_clear)
-                return;
-            
-            // Wait until the scheduled execution time
-            std::unique_lock<std::mutex> lock(mutex);
-            if (m_abort.wait_until(lock, next_execution) == std::cv_status::no_timeout) {
-                // Woken up by abort signal, not timeout
-                if (m_clear)
-                    return;
-            }
-            
-            if (m_clear)
-                return;
+    Scheduler::instance().schedule(m_task, function, interval, Clock::now() + interval);
+}
 
-            // Execute function
-            function();
-            
-            // Schedule next execution at fixed interval from the original schedule
-            next_execution += interval;
-            
-            // If we're already past the next scheduled time, execute immediately
-            auto now = steady_clock::now();
-            if (next_execution <= now) {
-                next_execution = now;
-            }
-        }
-    });
+void Timer::setTimeout(const std::function<void()>& function, nanoseconds delay)
+{
+    Scheduler::instance().schedule(m_task, function, nanoseconds::zero(), Clock::now() + delay);
 }
 
 void Timer::stop()
 {
-    if (m_thread.joinable())
-    {
-        m_clear = true;
-        m_abort.notify_all();
-        m_thread.join();
-    }
+    Scheduler::instance().cancel(m_task);
 }
 
-
+Stats Timer::getStats() const
+{
+    return Scheduler::instance().taskStats(*m_task);
+}
 
 } // namespace timer
@@ -1,26 +1,50 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
-#include <thread>
-#include <condition_variable>
 #include <memory>
 
 namespace timer
 {
 
+using Clock = std::chrono::steady_clock;
+
+// Runs that start later than this after their deadline are counted as missed
+static constexpr std::chrono::milliseconds MISSED_DEADLINE_TOLERANCE{5};
+
+struct Stats
+{
+    uint64_t runs = 0;
+    uint64_t missed_deadlines = 0;
+    std::chrono::nanoseconds worst_lateness{0};
+};
+
+namespace detail { struct Task; }
+
+/**
+ * Handle for a periodic or one-shot task.
+ *
+ * All timers share a single scheduler thread that runs tasks from one
+ * deadline-ordered queue, so callbacks never run concurrently with each
+ * other and must not block for long.
+ */
 class Timer
 {
 public:
+    Timer();
     ~Timer();
 
     void setInterval(const std::function<void()>& function, std::chrono::nanoseconds interval);
+    void setTimeout(const std::function<void()>& function, std::chrono::nanoseconds delay);
+
+    // Once stop() returns the callback is not running (unless called from the callback itself)
     void stop();
 
+    Stats getStats() const;
+
 private:
-    bool m_clear = false;
-    std::condition_variable m_abort;
-    std::thread m_thread;
+    std::shared_ptr<detail::Task> m_task;
 };
 
 std::unique_ptr<Timer> createTimer(
@@ -28,4 +52,12 @@ std::unique_ptr<Timer> createTimer(
     const std::function<void()>& callback
 );
 
+std::unique_ptr<Timer> createTimeout(
+    std::chrono::milliseconds delay,
+    const std::function<void()>& callback
+);
+
+// Aggregated stats for every task run by the shared scheduler
+Stats getSchedulerStats();
+
 } // namespace timer
@@ -1,59 +1,139 @@
-#include <iconv.h>
-#include <errno.h>
-#include <cstring>
-#include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 
 #include "utf8_converter.hpp"
 
 namespace utf8 {
 
-// Internal helper function to perform iconv conversion
-static std::string convertEncoding(const std::string& input, const char* to_encoding, const char* from_encoding, size_t buffer_multiplier = 4) {
-    if (input.empty()) {
-        return input;
+struct Transliteration {
+    char32_t code_point;
+    const char* latin1;
+};
+
+// Sorted by code point. Latin-1 letters are listed too, the font only has glyphs for a few of them.
+static constexpr Transliteration transliterations[] = {
+    // Latin-1 letters the font may not have, and Latin Extended-A
+    {0x00C0, "A"}, {0x00C1, "A"}, {0x00C2, "A"}, {0x00C3, "A"}, {0x00C4, "A"}, {0x00C5, "A"},
+    {0x00C6, "AE"}, {0x00C7, "C"}, {0x00C8, "E"}, {0x00C9, "E"}, {0x00CA, "E"}, {0x00CB, "E"},
+    {0x00CC, "I"}, {0x00CD, "I"}, {0x00CE, "I"}, {0x00CF, "I"}, {0x00D0, "D"}, {0x00D1, "N"},
+    {0x00D2, "O"}, {0x00D3, "O"}, {0x00D4, "O"}, {0x00D5, "O"}, {0x00D6, "O"}, {0x00D7, "x"},
+    {0x00D8, "O"}, {0x00D9, "U"}, {0x00DA, "U"}, {0x00DB, "U"}, {0x00DC, "U"}, {0x00DD, "Y"},
+    {0x00DE, "Th"}, {0x00DF, "ss"}, {0x00E0, "a"}, {0x00E1, "a"}, {0x00E2, "a"}, {0x00E3, "a"},
+    {0x00E4, "a"}, {0x00E5, "a"}, {0x00E6, "ae"}, {0x00E7, "c"}, {0x00E8, "e"}, {0x00E9, "e"},
+    {0x00EA, "e"}, {0x00EB, "e"}, {0x00EC, "i"}, {0x00ED, "i"}, {0x00EE, "i"}, {0x00EF, "i"},
+    {0x00F0, "d"}, {0x00F1, "n"}, {0x00F2, "o"}, {0x00F3, "o"}, {0x00F4, "o"}, {0x00F5, "o"},
+    {0x00F6, "o"}, {0x00F7, "/"}, {0x00F8, "o"}, {0x00F9, "u"}, {0x00FA, "u"}, {0x00FB, "u"},
+    {0x00FC, "u"}, {0x00FD, "y"}, {0x00FE, "th"}, {0x00FF, "y"}, {0x0100, "A"}, {0x0101, "a"},
+    {0x0102, "A"}, {0x0103, "a"}, {0x0104, "A"}, {0x0105, "a"}, {0x0106, "C"}, {0x0107, "c"},
+    {0x0108, "C"}, {0x0109, "c"}, {0x010A, "C"}, {0x010B, "c"}, {0x010C, "C"}, {0x010D, "c"},
+    {0x010E, "D"}, {0x010F, "d"}, {0x0110, "D"}, {0x0111, "d"}, {0x0112, "E"}, {0x0113, "e"},
+    {0x0114, "E"}, {0x0115, "e"}, {0x0116, "E"}, {0x0117, "e"}, {0x0118, "E"}, {0x0119, "e"},
+    {0x011A, "E"}, {0x011B, "e"}, {0x011C, "G"}, {0x011D, "g"}, {0x011E, "G"}, {0x011F, "g"},
+    {0x0120, "G"}, {0x0121, "g"}, {0x0122, "G"}, {0x0123, "g"}, {0x0124, "H"}, {0x0125, "h"},
+    {0x0126, "H"}, {0x0127, "h"}, {0x0128, "I"}, {0x0129, "i"}, {0x012A, "I"}, {0x012B, "i"},
+    {0x012C, "I"}, {0x012D, "i"}, {0x012E, "I"}, {0x012F, "i"}, {0x0130, "I"}, {0x0131, "i"},
+    {0x0132, "IJ"}, {0x0133, "ij"}, {0x0134, "J"}, {0x0135, "j"}, {0x0136, "K"}, {0x0137, "k"},
+    {0x0138, "k"}, {0x0139, "L"}, {0x013A, "l"}, {0x013B, "L"}, {0x013C, "l"}, {0x013D, "L"},
+    {0x013E, "l"}, {0x013F, "L"}, {0x0140, "l"}, {0x0141, "L"}, {0x0142, "l"}, {0x0143, "N"},
+    {0x0144, "n"}, {0x0145, "N"}, {0x0146, "n"}, {0x0147, "N"}, {0x0148, "n"}, {0x0149, "'n"},
+    {0x014A, "N"}, {0x014B, "n"}, {0x014C, "O"}, {0x014D, "o"}, {0x014E, "O"}, {0x014F, "o"},
+    {0x0150, "O"}, {0x0151, "o"}, {0x0152, "OE"}, {0x0153, "oe"}, {0x0154, "R"}, {0x0155, "r"},
+    {0x0156, "R"}, {0x0157, "r"}, {0x0158, "R"}, {0x0159, "r"}, {0x015A, "S"}, {0x015B, "s"},
+    {0x015C, "S"}, {0x015D, "s"}, {0x015E, "S"}, {0x015F, "s"}, {0x0160, "S"}, {0x0161, "s"},
+    {0x0162, "T"}, {0x0163, "t"}, {0x0164, "T"}, {0x0165, "t"}, {0x0166, "T"}, {0x0167, "t"},
+    {0x0168, "U"}, {0x0169, "u"}, {0x016A, "U"}, {0x016B, "u"}, {0x016C, "U"}, {0x016D, "u"},
+    {0x016E, "U"}, {0x016F, "u"}, {0x0170, "U"}, {0x0171, "u"}, {0x0172, "U"}, {0x0173, "u"},
+    {0x0174, "W"}, {0x0175, "w"}, {0x0176, "Y"}, {0x0177, "y"}, {0x0178, "Y"}, {0x0179, "Z"},
+    {0x017A, "z"}, {0x017B, "Z"}, {0x017C, "z"}, {0x017D, "Z"}, {0x017E, "z"}, {0x017F, "s"},
+    // Punctuation, symbols and ligatures
+    {0x2010, "-"}, {0x2011, "-"}, {0x2012, "-"}, {0x2013, "-"}, {0x2014, "-"}, {0x2015, "-"},
+    {0x2018, "'"}, {0x2019, "'"}, {0x201A, "'"}, {0x201B, "'"}, {0x201C, "\""}, {0x201D, "\""},
+    {0x201E, "\""}, {0x201F, "\""}, {0x2020, "+"}, {0x2022, "*"}, {0x2026, "..."}, {0x2030, "%"},
+    {0x2032, "'"}, {0x2033, "\""}, {0x2039, "<"}, {0x203A, ">"}, {0x20AC, "EUR"}, {0x2103, "\xb0" "C"},
+    {0x2109, "\xb0" "F"}, {0x2122, "TM"}, {0x2190, "<-"}, {0x2191, "^"}, {0x2192, "->"}, {0x2193, "v"},
+    {0x2212, "-"}, {0x2500, "-"}, {0x2502, "|"}, {0xFB00, "ff"}, {0xFB01, "fi"}, {0xFB02, "fl"},
+    {0xFB03, "ffi"}, {0xFB04, "ffl"},
+};
+
+static_assert(std::is_sorted(std::begin(transliterations), std::end(transliterations),
+                             [](const Transliteration& a, const Transliteration& b) { return a.code_point < b.code_point; }),
+              "transliterations must be sorted for the binary search");
+
+char32_t decode(const std::string& text, size_t& pos) {
+    const auto lead = static_cast<uint8_t>(text[pos]);
+    size_t length;
+    char32_t code_point;
+    char32_t minimum;
+
+    if (lead < 0x80) {
+        ++pos;
+        return lead;
+    } else if ((lead & 0xE0) == 0xC0) {
+        length = 2;
+        code_point = lead & 0x1Fu;
+        minimum = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+        length = 3;
+        code_point = lead & 0x0Fu;
+        minimum = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+        length = 4;
+        code_point = lead & 0x07u;
+        minimum = 0x10000;
+    } else {
+        ++pos;
+        return REPLACEMENT_CHARACTER;
     }
 
-    iconv_t cd = iconv_open(to_encoding, from_encoding);
-    if (cd == reinterpret_cast<iconv_t>(-1)) {
-        std::cerr << "Failed to open iconv descriptor for " << from_encoding << " to " << to_encoding << std::endl;
-        return input;
+    if (pos + length > text.size()) {
+        ++pos;
+        return REPLACEMENT_CHARACTER;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        const auto continuation = static_cast<uint8_t>(text[pos + i]);
+        if ((continuation & 0xC0) != 0x80) {
+            ++pos;
+            return REPLACEMENT_CHARACTER;
+        }
+        code_point = (code_point << 6) | (continuation & 0x3Fu);
     }
 
-    // Input buffer
-    const char* input_ptr = input.c_str();
-    size_t input_len = input.length();
-    
-    // Output buffer - allocate with multiplier for potential expansion
-    size_t output_len = input.length() * buffer_multiplier;
-    std::string result(output_len, '\0');
-    char* output = &result[0];
-    char* output_ptr = output;
-    
-    // Perform conversion
-    size_t conv_result = iconv(cd, const_cast<char**>(&input_ptr), &input_len, &output_ptr, &output_len);
-    
-    // Close conversion descriptor
-    iconv_close(cd);
-    
-    if (conv_result == static_cast<size_t>(-1)) {
-        // Conversion error - return best effort result
-        std::cerr << "Failed to convert from " << from_encoding << " to " << to_encoding 
-                  << ", errno: " << errno << " (" << strerror(errno) << ")" << std::endl;
-        result.resize(static_cast<size_t>(output_ptr - output));
-        return result;
+    // Overlong encodings, surrogates and values past the last plane
+    if (code_point < minimum || (code_point >= 0xD800 && code_point <= 0xDFFF) || code_point > 0x10FFFF) {
+        ++pos;
+        return REPLACEMENT_CHARACTER;
     }
-    
-    // Resize to actual converted length
-    result.resize(static_cast<size_t>(output_ptr - output));
-    return result;
+
+    pos += length;
+    return code_point;
 }
 
-std::string toLatin1(const std::string& utf8_string) {
-    return convertEncoding(utf8_string, "ISO-8859-1//TRANSLIT", "UTF-8", 2);
+void encode(char32_t code_point, std::string& out) {
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
 }
 
-std::string toUtf8(const std::string& latin1_string) {
-    return convertEncoding(latin1_string, "UTF-8", "ISO-8859-1", 4);
+const char* transliterate(char32_t code_point) {
+    auto it = std::lower_bound(std::begin(transliterations), std::end(transliterations), code_point,
+                               [](const Transliteration& entry, char32_t value) { return entry.code_point < value; });
+    if (it == std::end(transliterations) || it->code_point != code_point) {
+        return nullptr;
+    }
+    return it->latin1;
 }
 
 } // namespace utf8
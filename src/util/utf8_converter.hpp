@@ -3,6 +3,15 @@
 #include <string>
 
 namespace utf8 {
-    std::string toLatin1(const std::string& utf8_string);
-    std::string toUtf8(const std::string& latin1_string);
+    // Replacement for malformed input
+    inline constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+    // Decodes the code point at pos and moves pos past it, a malformed sequence decodes as
+    // REPLACEMENT_CHARACTER and skips a single byte
+    char32_t decode(const std::string& text, size_t& pos);
+
+    void encode(char32_t code_point, std::string& out);
+
+    // Latin-1 spelling of a code point Latin-1 lacks, like "ss" for U+00DF, or nullptr if there is none
+    const char* transliterate(char32_t code_point);
 }
@@ -112,6 +112,12 @@ def parse_char_name(char_name):
         return '\n'
     elif char_name == 'TAB':
         return '\t'
+    elif char_name.startswith('U+'):
+        # Code points beyond Latin-1, like 'U+2190'
+        try:
+            return chr(int(char_name[2:], 16))
+        except ValueError:
+            return None
     elif char_name.startswith('0x'):
         # Handle hex display names like '0xe6'
         hex_val = char_name[2:]
@@ -122,102 +128,106 @@ def parse_char_name(char_name):
     else:
         return char_name
 
+def char_comment(char):
+    """Readable name of a character for comments"""
+    names = {' ': 'space', '\'': 'single quote', '\\': 'backslash', '\n': 'newline', '\t': 'tab'}
+    if char in names:
+        return names[char]
+    if ord(char) > 255:
+        return f'U+{ord(char):04X}'
+    if ord(char) < 32 or ord(char) > 126:
+        return f'0x{ord(char):02x}'
+    return char
+
+# Glyph indices for code points beyond Latin-1, the C1 controls never have a glyph of their own
+EXTRA_GLYPH_SLOTS = range(0x80, 0xA0)
+
 def generate_header(characters, output_file):
-    """Generate modern C++ header file with std::unordered_map"""
-    # Create expanded character list from multi-character definitions
-    expanded_chars = []
-    
+    """Generate a C++ header with one flat column atlas, a 256-entry glyph table
+    and a sorted index from code points beyond Latin-1 to their glyph"""
+    # Atlas: each definition's columns once, followed by the blank column
+    # that separates it from the next glyph, so a glyph is a single copy
+    atlas = []
+    atlas_size = 0
+    table = {}
+    extra = {}  # code point -> glyph index
+
     for char_def in characters:
-        # Create separate entries for each character in the definition
+        columns = char_def['hex_bytes'][:char_def['width']]
+
         for i, char in enumerate(char_def['chars']):
-            char_info = {
-                'char': char,
-                'width': char_def['width'],
-                'hex_bytes': char_def['hex_bytes'],
-                'ascii_art': char_def['ascii_art']
-            }
-            
-            # Mark additional characters as mapped for comments
-            if i > 0:
-                char_info['mapped_from'] = char_def['chars'][0]
-            
-            expanded_chars.append(char_info)
-    
+            if not char or len(char) != 1:
+                continue
+            code = ord(char)
+            if code > 255:
+                if len(extra) == len(EXTRA_GLYPH_SLOTS):
+                    raise ValueError(f"Only {len(EXTRA_GLYPH_SLOTS)} glyphs beyond Latin-1 fit the glyph table")
+                code = EXTRA_GLYPH_SLOTS[len(extra)]
+                extra[ord(char)] = code
+            elif code in EXTRA_GLYPH_SLOTS:
+                raise ValueError(f"0x{code:02x} is reserved for glyphs beyond Latin-1")
+            # Additional characters share the first one's columns
+            table[code] = (atlas_size, len(columns) + 1, char_def['chars'][0] if i > 0 else None, char)
+
+        atlas.append((columns, char_def['chars']))
+        atlas_size += len(columns) + 1
+
+    if atlas_size > 0xFFFF:
+        raise ValueError(f"Font atlas of {atlas_size} columns does not fit 16-bit offsets")
+    if ord(' ') not in table:
+        raise ValueError("Font must define SPACE, it is used for characters without a glyph")
+
     with open(output_file, 'w') as f:
         f.write('#ifndef FONT_GENERATED_HPP\n')
         f.write('#define FONT_GENERATED_HPP\n\n')
-        f.write('#include <unordered_map>\n')
-        f.write('#include <vector>\n')
+        f.write('#include <array>\n')
         f.write('#include <cstdint>\n\n')
-        
+
         f.write('namespace font {\n\n')
-        
-        # Generate the font data type - just a vector of columns
-        f.write('using GlyphData = std::vector<uint8_t>;\n\n')
-        
-        # Generate the font map
-        f.write('const std::unordered_map<char, GlyphData> fontMap = {\n')
-        
-        valid_chars = []
-        for char in expanded_chars:
-            # Skip empty or invalid characters
-            if not char['char'] or len(char['char']) == 0:
-                continue
-            valid_chars.append(char)
-        
-        for i, char in enumerate(valid_chars):
-            # Only include actual glyph data columns (no width encoding, no padding)
-            actual_columns = char['hex_bytes'][:char['width']]
-            columns_str = ', '.join(f'0x{b:02x}' for b in actual_columns)
-            
-            # Generate character key with proper escaping
-            if char['char'] == ' ':
-                char_key = "' '"
-                comment = ' // space'
-            elif char['char'] == '\'':
-                char_key = "'\\''"
-                comment = ' // single quote'
-            elif char['char'] == '\\':
-                char_key = "'\\\\'"
-                comment = ' // backslash'
-            elif char['char'] == '\n':
-                char_key = "'\\n'"
-                comment = ' // newline'
-            elif char['char'] == '\t':
-                char_key = "'\\t'"
-                comment = ' // tab'
-            elif len(char['char']) == 1 and ord(char['char']) > 127:
-                char_key = f"'\\x{ord(char['char']):02x}'"
-                if 'mapped_from' in char:
-                    mapped_from_hex = f'0x{ord(char["mapped_from"]):02x}'
-                    comment = f' // 0x{ord(char["char"]):02x} -> {mapped_from_hex}'
-                else:
-                    comment = f' // 0x{ord(char["char"]):02x}'
-            else:
-                char_key = f"'{char['char']}'"
-                if 'mapped_from' in char:
-                    comment = f' // {char["char"]} -> {char["mapped_from"]}'
-                else:
-                    comment = f' // {char["char"]}'
-            
-            if i < len(valid_chars) - 1:
-                f.write(f'    {{{char_key}, {{{columns_str}}}}},' + comment + '\n')
+
+        f.write('// Columns of every glyph back to back, each followed by a blank column\n')
+        f.write('inline constexpr uint8_t fontAtlas[] = {\n')
+        for columns, chars in atlas:
+            columns_str = ', '.join(f'0x{b:02x}' for b in columns + [0])
+            f.write(f'    {columns_str}, // {char_comment(chars[0])}\n')
+        f.write('};\n\n')
+
+        f.write('struct Glyph {\n')
+        f.write('    uint16_t offset;   // first column in fontAtlas\n')
+        f.write('    uint8_t advance;   // glyph columns plus the blank column after them\n')
+        f.write('    bool defined;      // false for characters shown as a space for lack of a glyph\n')
+        f.write('};\n\n')
+
+        f.write('// Indexed by the Latin-1 character, characters without a glyph are a space.\n')
+        f.write(f'// 0x{EXTRA_GLYPH_SLOTS[0]:02x}-0x{EXTRA_GLYPH_SLOTS[-1]:02x} hold the glyphs beyond Latin-1, see extraGlyphs\n')
+        f.write('inline constexpr Glyph glyphTable[256] = {\n')
+        space = table[ord(' ')]
+        for code in range(256):
+            if code in table:
+                offset, advance, mapped_from, char = table[code]
+                comment = char_comment(char)
+                if mapped_from is not None:
+                    comment += f' -> {char_comment(mapped_from)}'
+                f.write(f'    {{{offset}, {advance}, true}}, // {comment}\n')
             else:
-                f.write(f'    {{{char_key}, {{{columns_str}}}}}' + comment + '\n')
-        
+                f.write(f'    {{{space[0]}, {space[1]}, false}}, // 0x{code:02x} (space)\n')
         f.write('};\n\n')
-        
-        # Generate helper function to get glyph with fallback
-        f.write('inline const GlyphData* getGlyph(char c) {\n')
-        f.write('    auto it = fontMap.find(c);\n')
-        f.write('    if (it != fontMap.end()) {\n')
-        f.write('        return &it->second;\n')
-        f.write('    }\n')
-        f.write('    // Fallback to space character\n')
-        f.write('    auto fallback = fontMap.find(\' \');\n')
-        f.write('    return (fallback != fontMap.end()) ? &fallback->second : nullptr;\n')
+
+        f.write('struct ExtraGlyph {\n')
+        f.write('    char32_t code_point;\n')
+        f.write('    uint8_t index;     // into glyphTable\n')
+        f.write('};\n\n')
+
+        f.write('// Glyphs beyond Latin-1, sorted by code point\n')
+        f.write(f'inline constexpr std::array<ExtraGlyph, {len(extra)}> extraGlyphs = {{{{\n')
+        for code_point in sorted(extra):
+            f.write(f'    {{0x{code_point:04X}, 0x{extra[code_point]:02x}}}, // {char_comment(chr(code_point))}\n')
+        f.write('}};\n\n')
+
+        f.write('constexpr const Glyph& getGlyph(char c) {\n')
+        f.write('    return glyphTable[static_cast<uint8_t>(c)];\n')
         f.write('}\n\n')
-        
+
         f.write('} // namespace font\n\n')
         f.write('#endif // FONT_GENERATED_HPP\n')
 